@@ -0,0 +1,330 @@
+// a small benchmark harness shared by the vector, map and deque benchmarks
+// steady_clock or rdtsc timing, warmup, repetitions, median / p99, fixed seeds and text / csv / json output,
+// plus per operation hardware counters where perf_event_open is allowed
+#ifndef SJTU_BENCH_HPP
+#define SJTU_BENCH_HPP
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#define SJTU_BENCH_HAS_TSC 1
+#endif
+#include "perf.hpp"
+
+namespace bench {
+
+	/**
+	 * command line options, every benchmark accepts
+	 *   --sizes=1000,100000  --reps=11  --warmup=2  --seed=20190401
+	 *   --format=text|csv|json  --filter=<substring of suite/impl/op>  --clock=steady|tsc  --counters=on|off
+	 */
+	struct options {
+		std::vector<long> sizes;
+		int repetitions = 11;
+		int warmup = 2;
+		std::uint64_t seed = 20190401;
+		std::string format = "text";
+		std::string filter;
+		bool tsc = false;
+		bool counters = true;
+
+		options () : sizes({1000, 100000}) {}
+	};
+
+	inline options parse (int argc, char *argv[]) {
+		options opt;
+		for (int i = 1; i < argc; i++) {
+			const char *arg = argv[i];
+			const char *eq = strchr(arg, '=');
+			std::string key = eq == nullptr ? std::string(arg) : std::string(arg, eq - arg);
+			std::string value = eq == nullptr ? std::string() : std::string(eq + 1);
+			if (key == "--sizes") {
+				opt.sizes.clear();
+				for (size_t p = 0; p < value.size();) {
+					size_t q = value.find(',', p);
+					if (q == std::string::npos) {
+						q = value.size();
+					}
+					// 1e6 style sizes are accepted as well
+					opt.sizes.push_back((long) atof(value.substr(p, q - p).c_str()));
+					p = q + 1;
+				}
+			} else if (key == "--reps") {
+				opt.repetitions = std::max(1, atoi(value.c_str()));
+			} else if (key == "--warmup") {
+				opt.warmup = std::max(0, atoi(value.c_str()));
+			} else if (key == "--seed") {
+				opt.seed = strtoull(value.c_str(), nullptr, 10);
+			} else if (key == "--format") {
+				opt.format = value;
+			} else if (key == "--filter") {
+				opt.filter = value;
+			} else if (key == "--clock") {
+				opt.tsc = value == "tsc";
+			} else if (key == "--counters") {
+				opt.counters = value != "off";
+			} else {
+				fprintf(stderr, "unknown option %s\n", arg);
+				exit(1);
+			}
+		}
+#ifndef SJTU_BENCH_HAS_TSC
+		opt.tsc = false;
+#endif
+		return opt;
+	}
+
+	/**
+	 * splitmix64, the same sequence on every platform for a given seed.
+	 */
+	class rng {
+	private:
+		std::uint64_t state;
+
+	public:
+		explicit rng (std::uint64_t seed) : state(seed) {}
+
+		std::uint64_t next () {
+			std::uint64_t z = (state += 0x9E3779B97F4A7C15ull);
+			z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+			z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+			return z ^ (z >> 31);
+		}
+
+		// uniform in [0, n)
+		std::uint64_t below (std::uint64_t n) {
+			return next() % n;
+		}
+	};
+
+	/**
+	 * keep the compiler from dropping a computed value.
+	 */
+	template<class T>
+	inline void keep (const T &value) {
+#if defined(__GNUC__)
+		asm volatile("" : : "r,m"(value) : "memory");
+#else
+		static volatile char sink;
+		sink = *(const volatile char *) &value;
+#endif
+	}
+
+	struct result {
+		std::string suite, impl, op;
+		long n;
+		long ops;
+		// per operation, in ns or cycles
+		double median, p99, min, mean;
+		// filled in when the same suite / op / n was run for a std:: implementation
+		double baseline = 0;
+		// per operation hardware counts, negative when the counter is unavailable
+		double counts[counters::COUNT];
+	};
+
+	class runner {
+	private:
+		options opt;
+		std::vector<result> results;
+		counters events;
+		// counted runs are separate from the timed ones, so the ioctls never land inside a timing
+		static const int COUNTED_RUNS = 3;
+
+		double now () const {
+#ifdef SJTU_BENCH_HAS_TSC
+			if (opt.tsc) {
+				return (double) __rdtsc();
+			}
+#endif
+			return (double) std::chrono::duration_cast<std::chrono::nanoseconds>(
+					std::chrono::steady_clock::now().time_since_epoch()).count();
+		}
+
+		static double percentile (const std::vector<double> &sorted, double p) {
+			size_t i = (size_t) (p * (sorted.size() - 1) + 0.5);
+			return sorted[std::min(i, sorted.size() - 1)];
+		}
+
+	public:
+		explicit runner (const options &opt) : opt(opt), events(opt.counters) {
+			if (opt.counters && !events.unavailable().empty()) {
+				fprintf(stderr, "%s counters: %s\n", events.any() ? "some" : "no", events.unavailable().c_str());
+			}
+		}
+
+		const options &config () const {
+			return opt;
+		}
+
+		const char *unit () const {
+			return opt.tsc ? "cycles" : "ns";
+		}
+
+		bool selected (const std::string &suite, const std::string &impl, const std::string &op) const {
+			if (opt.filter.empty()) {
+				return true;
+			}
+			std::string name = suite + "/" + impl + "/" + op;
+			return name.find(opt.filter) != std::string::npos;
+		}
+
+		/**
+		 * setup builds the input outside of the timed region and returns it,
+		 * body runs ops operations on it; every repetition gets a fresh input.
+		 */
+		template<class Setup, class Body>
+		void measure (const std::string &suite, const std::string &impl, const std::string &op, long n, long ops,
+		              Setup setup, Body body) {
+			if (!selected(suite, impl, op) || ops <= 0) {
+				return;
+			}
+			std::vector<double> samples;
+			for (int rep = 0; rep < opt.warmup + opt.repetitions; rep++) {
+				auto input = setup();
+				double begin = now();
+				body(input);
+				double elapsed = now() - begin;
+				if (rep >= opt.warmup) {
+					samples.push_back(elapsed / ops);
+				}
+			}
+			std::sort(samples.begin(), samples.end());
+			result r;
+			r.suite = suite;
+			r.impl = impl;
+			r.op = op;
+			r.n = n;
+			r.ops = ops;
+			r.median = percentile(samples, 0.5);
+			r.p99 = percentile(samples, 0.99);
+			r.min = samples.front();
+			double sum = 0;
+			for (double s : samples) {
+				sum += s;
+			}
+			r.mean = sum / samples.size();
+			double total[counters::COUNT] = {};
+			int runs = events.any() ? std::min(COUNTED_RUNS, opt.repetitions) : 0;
+			for (int rep = 0; rep < runs; rep++) {
+				auto input = setup();
+				events.start();
+				body(input);
+				events.stop(total);
+			}
+			for (int i = 0; i < counters::COUNT; i++) {
+				r.counts[i] = events.available(i) ? total[i] / ((double) runs * ops) : -1;
+			}
+			results.push_back(r);
+		}
+
+		// the second text table, hardware counts per operation
+		void report_counters () const {
+			printf("\n%-8s %-22s %-14s %10s %9s %9s %6s", "suite", "impl", "op", "n", "cycles", "instr", "IPC");
+			for (int i = 2; i < counters::COUNT; i++) {
+				printf(" %11s", counters::name(i));
+			}
+			printf("   (per operation)\n");
+			for (auto &r : results) {
+				printf("%-8s %-22s %-14s %10ld", r.suite.c_str(), r.impl.c_str(), r.op.c_str(), r.n);
+				for (int i = 0; i < 2; i++) {
+					if (r.counts[i] >= 0) {
+						printf(" %9.1f", r.counts[i]);
+					} else {
+						printf(" %9s", "-");
+					}
+				}
+				if (r.counts[0] > 0 && r.counts[1] >= 0) {
+					printf(" %6.2f", r.counts[1] / r.counts[0]);
+				} else {
+					printf(" %6s", "-");
+				}
+				for (int i = 2; i < counters::COUNT; i++) {
+					if (r.counts[i] >= 0) {
+						printf(" %11.3f", r.counts[i]);
+					} else {
+						printf(" %11s", "-");
+					}
+				}
+				printf("\n");
+			}
+		}
+
+		const std::vector<result> &report () {
+			for (auto &r : results) {
+				for (auto &base : results) {
+					if (base.impl.compare(0, 5, "std::") == 0 && base.suite == r.suite && base.op == r.op &&
+					    base.n == r.n) {
+						r.baseline = base.median;
+					}
+				}
+			}
+			if (opt.format == "csv") {
+				printf("suite,impl,op,n,ops,unit,median,p99,min,mean,vs_std");
+				for (int i = 0; i < counters::COUNT; i++) {
+					printf(",%s", counters::name(i));
+				}
+				printf("\n");
+				for (auto &r : results) {
+					printf("%s,%s,%s,%ld,%ld,%s,%.3f,%.3f,%.3f,%.3f,%.3f", r.suite.c_str(), r.impl.c_str(),
+					       r.op.c_str(), r.n, r.ops, unit(), r.median, r.p99, r.min, r.mean,
+					       r.baseline > 0 ? r.median / r.baseline : 0.0);
+					// an empty field for a counter that is unavailable
+					for (int i = 0; i < counters::COUNT; i++) {
+						if (r.counts[i] >= 0) {
+							printf(",%.3f", r.counts[i]);
+						} else {
+							printf(",");
+						}
+					}
+					printf("\n");
+				}
+			} else if (opt.format == "json") {
+				printf("{\"unit\": \"%s\", \"seed\": %llu, \"repetitions\": %d, \"warmup\": %d, \"results\": [\n",
+				       unit(), (unsigned long long) opt.seed, opt.repetitions, opt.warmup);
+				for (size_t i = 0; i < results.size(); i++) {
+					auto &r = results[i];
+					printf("  {\"suite\": \"%s\", \"impl\": \"%s\", \"op\": \"%s\", \"n\": %ld, \"ops\": %ld, "
+					       "\"median\": %.3f, \"p99\": %.3f, \"min\": %.3f, \"mean\": %.3f, \"vs_std\": %.3f",
+					       r.suite.c_str(), r.impl.c_str(), r.op.c_str(), r.n, r.ops, r.median, r.p99, r.min, r.mean,
+					       r.baseline > 0 ? r.median / r.baseline : 0.0);
+					// null for a counter that is unavailable
+					for (int c = 0; c < counters::COUNT; c++) {
+						if (r.counts[c] >= 0) {
+							printf(", \"%s\": %.3f", counters::name(c), r.counts[c]);
+						} else {
+							printf(", \"%s\": null", counters::name(c));
+						}
+					}
+					printf("}%s\n", i + 1 == results.size() ? "" : ",");
+				}
+				printf("]}\n");
+			} else {
+				printf("%-8s %-22s %-14s %10s %12s %12s %12s %8s   (%s per operation)\n", "suite", "impl", "op", "n",
+				       "median", "p99", "min", "vs std", unit());
+				for (auto &r : results) {
+					printf("%-8s %-22s %-14s %10ld %12.2f %12.2f %12.2f", r.suite.c_str(), r.impl.c_str(),
+					       r.op.c_str(), r.n, r.median, r.p99, r.min);
+					if (r.baseline > 0) {
+						printf(" %7.2fx\n", r.median / r.baseline);
+					} else {
+						printf(" %8s\n", "-");
+					}
+				}
+				if (events.any()) {
+					report_counters();
+				}
+			}
+			return results;
+		}
+	};
+
+}
+
+#endif
@@ -0,0 +1,75 @@
+// Util::Bint on operands of n decimal digits each: every multiplication algorithm, addition and parsing
+// usage: bint [--sizes=64,256,...] [--reps=11] [--warmup=2] [--seed=N] [--format=text|csv|json]
+//             [--filter=substring] [--clock=steady|tsc] [--counters=on|off]
+// schoolbook stops at 65536 digits, where one product already takes about a second
+
+#include <cstring>
+#include <string>
+#include "../vector/data/class-bint.hpp"
+#include "bench.hpp"
+
+std::string digits (bench::rng &random, long n) {
+	std::string s(n, '0');
+	s[0] = (char) ('1' + random.below(9));
+	for (long i = 1; i < n; i++) {
+		s[i] = (char) ('0' + random.below(10));
+	}
+	return s;
+}
+
+void multiply (bench::runner &run, const char *impl, Util::Bint::Multiplication method, long n,
+               const Util::Bint &a, const Util::Bint &b) {
+	// enough products per repetition that the clock is not what is measured
+	long ops = std::max(1L, 200000 / n);
+	run.measure("bint", impl, "multiply", n, ops, [] { return 0; }, [&] (int &) {
+		for (long i = 0; i < ops; i++) {
+			bench::keep(Util::Bint::multiply(a, b, method));
+		}
+	});
+}
+
+void others (bench::runner &run, long n, const std::string &text, const Util::Bint &a, const Util::Bint &b) {
+	long ops = std::max(1L, 2000000 / n);
+	run.measure("bint", "operator+", "add", n, ops, [] { return 0; }, [&] (int &) {
+		for (long i = 0; i < ops; i++) {
+			bench::keep(a + b);
+		}
+	});
+	run.measure("bint", "operator-", "subtract", n, ops, [] { return 0; }, [&] (int &) {
+		for (long i = 0; i < ops; i++) {
+			bench::keep(a - b);
+		}
+	});
+	ops = std::max(1L, 200000 / n);
+	run.measure("bint", "Bint(string)", "parse", n, ops, [] { return 0; }, [&] (int &) {
+		for (long i = 0; i < ops; i++) {
+			bench::keep(Util::Bint(text));
+		}
+	});
+}
+
+int main (int argc, char *argv[]) {
+	bench::options opt = bench::parse(argc, argv);
+	bool sized = false;
+	for (int i = 1; i < argc; i++) {
+		sized |= strncmp(argv[i], "--sizes", 7) == 0;
+	}
+	if (!sized) {
+		opt.sizes = {64, 256, 1024, 4096, 16384, 65536, 262144, 1048576};
+	}
+	bench::runner run(opt);
+	bench::rng random(opt.seed);
+	for (long n : opt.sizes) {
+		std::string text = digits(random, n);
+		Util::Bint a(text), b(digits(random, n));
+		if (n <= 65536) {
+			multiply(run, "schoolbook", Util::Bint::SCHOOLBOOK, n, a, b);
+		}
+		multiply(run, "karatsuba", Util::Bint::KARATSUBA, n, a, b);
+		multiply(run, "ntt", Util::Bint::NTT, n, a, b);
+		multiply(run, "operator*", Util::Bint::AUTO, n, a, b);
+		others(run, n, text, a, b);
+	}
+	run.report();
+	return 0;
+}
@@ -0,0 +1,190 @@
+// sjtu::vector, sjtu::map and sjtu::deque side by side with their std:: counterparts
+// usage: containers [--sizes=1000,100000] [--reps=11] [--warmup=2] [--seed=N] [--format=text|csv|json]
+//                   [--filter=substring] [--clock=steady|tsc] [--counters=on|off]
+
+#include <algorithm>
+#include <deque>
+#include <map>
+#include <numeric>
+#include <vector>
+// map first: its exceptions.hpp is the only one that declares InsertionFailure,
+// the other copies share the include guard and are skipped
+#include "../map/map.hpp"
+#include "../vector/vector.hpp"
+#include "../deque/deque.hpp"
+#include "../deque/ring_deque.hpp"
+#include "bench.hpp"
+
+// n distinct keys in random order
+std::vector<int> distinct_keys (long n, bench::rng &random) {
+	std::vector<int> keys(n);
+	for (long i = 0; i < n; i++) {
+		keys[i] = (int) (i * 2 + 1);
+	}
+	for (long i = n - 1; i > 0; i--) {
+		std::swap(keys[i], keys[random.below(i + 1)]);
+	}
+	return keys;
+}
+
+std::vector<long> random_indices (long count, long n, bench::rng &random) {
+	std::vector<long> indices(count);
+	for (auto &i : indices) {
+		i = (long) random.below(n);
+	}
+	return indices;
+}
+
+template<class Vector>
+void vector_suite (bench::runner &run, const char *impl, long n) {
+	bench::rng random(run.config().seed ^ (std::uint64_t) n);
+	auto indices = random_indices(n, n, random);
+	auto filled = [n] {
+		Vector v;
+		for (long i = 0; i < n; i++) {
+			v.push_back((int) i);
+		}
+		return v;
+	};
+	run.measure("vector", impl, "push_back", n, n, [] { return Vector(); }, [n] (Vector &v) {
+		for (long i = 0; i < n; i++) {
+			v.push_back((int) i);
+		}
+		bench::keep(v.size());
+	});
+	run.measure("vector", impl, "index", n, n, filled, [&] (Vector &v) {
+		long long sum = 0;
+		for (long i = 0; i < n; i++) {
+			sum += v[indices[i]];
+		}
+		bench::keep(sum);
+	});
+	run.measure("vector", impl, "iterate", n, n, filled, [] (Vector &v) {
+		long long sum = 0;
+		for (auto it = v.begin(); it != v.end(); ++it) {
+			sum += *it;
+		}
+		bench::keep(sum);
+	});
+	long inserts = std::min(n, 2000L);
+	run.measure("vector", impl, "insert", n, inserts, filled, [&] (Vector &v) {
+		for (long i = 0; i < inserts; i++) {
+			v.insert(v.begin() + (int) (indices[i] % (long) v.size()), (int) i);
+		}
+		bench::keep(v.size());
+	});
+	run.measure("vector", impl, "erase", n, inserts, filled, [&] (Vector &v) {
+		for (long i = 0; i < inserts; i++) {
+			v.erase(v.begin() + (int) (indices[i] % (long) v.size()));
+		}
+		bench::keep(v.size());
+	});
+}
+
+template<class Map>
+void map_suite (bench::runner &run, const char *impl, long n) {
+	bench::rng random(run.config().seed ^ (std::uint64_t) n);
+	auto keys = distinct_keys(n, random);
+	auto order = distinct_keys(n, random);
+	typedef typename Map::value_type value_type;
+	auto filled = [&] {
+		Map m;
+		for (long i = 0; i < n; i++) {
+			m.insert(value_type(keys[i], (int) i));
+		}
+		return m;
+	};
+	run.measure("map", impl, "insert", n, n, [] { return Map(); }, [&] (Map &m) {
+		for (long i = 0; i < n; i++) {
+			m.insert(value_type(keys[i], (int) i));
+		}
+		bench::keep(m.size());
+	});
+	run.measure("map", impl, "find", n, n, filled, [&] (Map &m) {
+		long long sum = 0;
+		for (long i = 0; i < n; i++) {
+			sum += m.find(order[i])->second;
+		}
+		bench::keep(sum);
+	});
+	run.measure("map", impl, "iterate", n, n, filled, [] (Map &m) {
+		long long sum = 0;
+		for (auto it = m.begin(); it != m.end(); ++it) {
+			sum += it->second;
+		}
+		bench::keep(sum);
+	});
+	run.measure("map", impl, "erase", n, n, filled, [&] (Map &m) {
+		for (long i = 0; i < n; i++) {
+			m.erase(m.find(order[i]));
+		}
+		bench::keep(m.size());
+	});
+}
+
+template<class Deque>
+void deque_suite (bench::runner &run, const char *impl, long n) {
+	bench::rng random(run.config().seed ^ (std::uint64_t) n);
+	auto indices = random_indices(n, n, random);
+	auto filled = [n] {
+		Deque d;
+		for (long i = 0; i < n; i++) {
+			d.push_back((int) i);
+		}
+		return d;
+	};
+	run.measure("deque", impl, "push_back", n, n, [] { return Deque(); }, [n] (Deque &d) {
+		for (long i = 0; i < n; i++) {
+			d.push_back((int) i);
+		}
+		bench::keep(d.size());
+	});
+	run.measure("deque", impl, "push_front", n, n, [] { return Deque(); }, [n] (Deque &d) {
+		for (long i = 0; i < n; i++) {
+			d.push_front((int) i);
+		}
+		bench::keep(d.size());
+	});
+	run.measure("deque", impl, "at", n, n, filled, [&] (Deque &d) {
+		long long sum = 0;
+		for (long i = 0; i < n; i++) {
+			sum += d.at(indices[i]);
+		}
+		bench::keep(sum);
+	});
+	run.measure("deque", impl, "iterate", n, n, filled, [] (Deque &d) {
+		long long sum = 0;
+		for (auto it = d.begin(); it != d.end(); ++it) {
+			sum += *it;
+		}
+		bench::keep(sum);
+	});
+	long middle = std::min(n, 2000L);
+	run.measure("deque", impl, "insert", n, middle, filled, [&] (Deque &d) {
+		for (long i = 0; i < middle; i++) {
+			d.insert(d.begin() + (int) (indices[i] % (long) d.size()), (int) i);
+		}
+		bench::keep(d.size());
+	});
+	run.measure("deque", impl, "erase", n, middle, filled, [&] (Deque &d) {
+		for (long i = 0; i < middle; i++) {
+			d.erase(d.begin() + (int) (indices[i] % (long) d.size()));
+		}
+		bench::keep(d.size());
+	});
+}
+
+int main (int argc, char *argv[]) {
+	bench::runner run(bench::parse(argc, argv));
+	for (long n : run.config().sizes) {
+		vector_suite<sjtu::vector<int>>(run, "sjtu::vector", n);
+		vector_suite<std::vector<int>>(run, "std::vector", n);
+		map_suite<sjtu::map<int, int>>(run, "sjtu::map", n);
+		map_suite<std::map<int, int>>(run, "std::map", n);
+		deque_suite<sjtu::deque<int>>(run, "sjtu::deque", n);
+		deque_suite<sjtu::ring_deque<int>>(run, "sjtu::ring_deque", n);
+		deque_suite<std::deque<int>>(run, "std::deque", n);
+	}
+	run.report();
+	return 0;
+}
@@ -0,0 +1,107 @@
+// Diamond::Matrix products of two n x n matrices, in ns per multiply-add
+// usage: matrix [--sizes=4,16,64,...,2048] [--threads=N] [--reps=11] [--warmup=2] [--format=text|csv|json]
+//               [--filter=substring] [--clock=steady|tsc] [--counters=on|off]
+// "rows i-j-k" is what operator* used to be, an i-j-k loop over one std::vector per row; it stops at 1024,
+// where one product already takes seconds
+
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <thread>
+#include <vector>
+#include "../vector/data/class-matrix.hpp"
+#include "bench.hpp"
+
+template<class T>
+Diamond::Matrix<T> random_matrix (bench::rng &random, long n) {
+	Diamond::Matrix<T> m(n, n);
+	for (long i = 0; i < n; i++) {
+		for (long j = 0; j < n; j++) {
+			m[i][j] = (T) random.below(2001) / (T) 1000 - (T) 1;
+		}
+	}
+	return m;
+}
+
+template<class T>
+using rows = std::vector<std::vector<T>>;
+
+template<class T>
+rows<T> to_rows (const Diamond::Matrix<T> &m) {
+	rows<T> r(m.RowSize(), std::vector<T>(m.ColSize()));
+	for (size_t i = 0; i < m.RowSize(); ++i) {
+		for (size_t j = 0; j < m.ColSize(); ++j) {
+			r[i][j] = m[i][j];
+		}
+	}
+	return r;
+}
+
+template<class T>
+rows<T> ijk (const rows<T> &a, const rows<T> &b) {
+	rows<T> c(a.size(), std::vector<T>(b[0].size(), 0));
+	for (size_t i = 0; i < a.size(); ++i) {
+		for (size_t j = 0; j < b[0].size(); ++j) {
+			for (size_t k = 0; k < b.size(); ++k) {
+				c[i][j] += a[i][k] * b[k][j];
+			}
+		}
+	}
+	return c;
+}
+
+template<class T>
+void suite (bench::runner &run, const char *op, bench::rng &random, long n, size_t threads) {
+	Diamond::Matrix<T> a = random_matrix<T>(random, n), b = random_matrix<T>(random, n);
+	// enough products per repetition that the clock is not what is measured for the small sizes
+	long products = std::max(1L, (1L << 21) / (n * n * n)), ops = products * n * n * n;
+	if (n <= 1024) {
+		rows<T> ra = to_rows(a), rb = to_rows(b);
+		run.measure("matrix", "rows i-j-k", op, n, ops, [] { return 0; }, [&] (int &) {
+			for (long i = 0; i < products; i++) {
+				bench::keep(ijk(ra, rb));
+			}
+		});
+	}
+	run.measure("matrix", "operator*", op, n, ops, [] { return 0; }, [&] (int &) {
+		for (long i = 0; i < products; i++) {
+			bench::keep(a * b);
+		}
+	});
+	if (threads > 1) {
+		std::string impl = "Multiply x" + std::to_string(threads);
+		run.measure("matrix", impl, op, n, ops, [] { return 0; }, [&] (int &) {
+			for (long i = 0; i < products; i++) {
+				bench::keep(Diamond::Multiply(a, b, threads));
+			}
+		});
+	}
+}
+
+int main (int argc, char *argv[]) {
+	size_t threads = std::thread::hardware_concurrency();
+	bool sized = false;
+	// the remaining options go to bench::parse
+	std::vector<char *> rest(1, argv[0]);
+	for (int i = 1; i < argc; i++) {
+		if (strncmp(argv[i], "--threads=", 10) == 0) {
+			threads = (size_t) atoi(argv[i] + 10);
+			continue;
+		}
+		sized |= strncmp(argv[i], "--sizes", 7) == 0;
+		rest.push_back(argv[i]);
+	}
+	bench::options opt = bench::parse((int) rest.size(), rest.data());
+	if (!sized) {
+		opt.sizes = {4, 16, 64, 128, 256, 512, 1024, 2048};
+	}
+	bench::runner run(opt);
+	bench::rng random(opt.seed);
+	for (long n : opt.sizes) {
+		suite<double>(run, "double", random, n, threads);
+		suite<float>(run, "float", random, n, threads);
+	}
+	run.report();
+	return 0;
+}
@@ -0,0 +1,174 @@
+// bytes per element of sjtu::vector, sjtu::map and sjtu::deque for int, Util::Bint and Diamond::Matrix<double>
+// payload and overhead come from memory_usage(), heap is what malloc reports in use (glibc only), which also
+// counts the memory the elements own and malloc's own headers; the std:: rows only have the heap column
+// usage: memory [--sizes=1000,100000] [--format=text|csv]
+
+#include <cstdio>
+#include <deque>
+#include <map>
+#include <string>
+#include <vector>
+#ifdef __GLIBC__
+#include <malloc.h>
+#endif
+// map first: its exceptions.hpp is the only one that declares InsertionFailure,
+// the other copies share the include guard and are skipped
+#include "../map/map.hpp"
+#include "../vector/vector.hpp"
+#include "../deque/deque.hpp"
+#include "../vector/data/class-bint.hpp"
+#include "../vector/data/class-matrix.hpp"
+#include "bench.hpp"
+
+// bytes malloc has handed out and not got back, -1 where that cannot be asked
+long long heap_in_use () {
+#if defined(__GLIBC__) && (__GLIBC__ > 2 || (__GLIBC__ == 2 && __GLIBC_MINOR__ >= 33))
+	struct mallinfo2 info = mallinfo2();
+	return (long long) (info.uordblks + info.hblkhd);
+#else
+	return -1;
+#endif
+}
+
+struct row {
+	std::string container, payload;
+	long n;
+	double payload_bytes, overhead_bytes, heap_bytes;
+};
+
+std::vector<row> rows;
+
+int make_value (long i, int) {
+	return (int) i;
+}
+
+Util::Bint make_value (long i, Util::Bint) {
+	return Util::Bint((long long) i * 1000000007LL);
+}
+
+Diamond::Matrix<double> make_value (long i, Diamond::Matrix<double>) {
+	return Diamond::Matrix<double>(4, 4, (double) i);
+}
+
+// memory_usage() of the sjtu containers, false for the std:: ones
+template<class C>
+bool footprint (const C &, sjtu::container_memory &) {
+	return false;
+}
+
+template<class T>
+bool footprint (const sjtu::vector<T> &c, sjtu::container_memory &m) {
+	m = c.memory_usage();
+	return true;
+}
+
+template<class Key, class Value>
+bool footprint (const sjtu::map<Key, Value> &c, sjtu::container_memory &m) {
+	m = c.memory_usage();
+	return true;
+}
+
+template<class T>
+bool footprint (const sjtu::deque<T> &c, sjtu::container_memory &m) {
+	m = c.memory_usage();
+	return true;
+}
+
+// fill builds the container from nothing, so the heap delta around it is all the container's
+template<class Container, class Fill>
+void measure (const char *container, const char *payload, long n, Fill fill) {
+	long long before = heap_in_use();
+	auto c = new Container;
+	fill(*c);
+	long long after = heap_in_use();
+	row r;
+	r.container = container;
+	r.payload = payload;
+	r.n = n;
+	r.payload_bytes = r.overhead_bytes = -1;
+	r.heap_bytes = before < 0 ? -1 : (double) (after - before) / n;
+	sjtu::container_memory m;
+	if (footprint(*c, m)) {
+		r.payload_bytes = (double) m.payload / n;
+		r.overhead_bytes = (double) m.overhead / n;
+	}
+	delete c;
+	rows.push_back(r);
+}
+
+template<class T>
+void payload (const char *name, long n) {
+	T sample = make_value(0, T());
+	measure<sjtu::vector<T>>("sjtu::vector", name, n, [&] (sjtu::vector<T> &v) {
+		for (long i = 0; i < n; i++) {
+			v.push_back(make_value(i, sample));
+		}
+	});
+	measure<std::vector<T>>("std::vector", name, n, [&] (std::vector<T> &v) {
+		for (long i = 0; i < n; i++) {
+			v.push_back(make_value(i, sample));
+		}
+	});
+	measure<sjtu::map<int, T>>("sjtu::map", name, n, [&] (sjtu::map<int, T> &m) {
+		for (long i = 0; i < n; i++) {
+			m.insert(sjtu::pair<const int, T>((int) i, make_value(i, sample)));
+		}
+	});
+	measure<std::map<int, T>>("std::map", name, n, [&] (std::map<int, T> &m) {
+		for (long i = 0; i < n; i++) {
+			m.insert(std::pair<const int, T>((int) i, make_value(i, sample)));
+		}
+	});
+	measure<sjtu::deque<T>>("sjtu::deque", name, n, [&] (sjtu::deque<T> &d) {
+		for (long i = 0; i < n; i++) {
+			d.push_back(make_value(i, sample));
+		}
+	});
+	measure<std::deque<T>>("std::deque", name, n, [&] (std::deque<T> &d) {
+		for (long i = 0; i < n; i++) {
+			d.push_back(make_value(i, sample));
+		}
+	});
+}
+
+void print_cell (double value, bool csv) {
+	if (csv) {
+		if (value < 0) {
+			printf(",");
+		} else {
+			printf(",%.2f", value);
+		}
+	} else if (value < 0) {
+		printf(" %10s", "-");
+	} else {
+		printf(" %10.2f", value);
+	}
+}
+
+int main (int argc, char *argv[]) {
+	bench::options opt = bench::parse(argc, argv);
+	for (long n : opt.sizes) {
+		payload<int>("int", n);
+		payload<Util::Bint>("Bint", n);
+		payload<Diamond::Matrix<double>>("Matrix<double>", n);
+	}
+	bool csv = opt.format == "csv";
+	if (csv) {
+		printf("container,payload,n,payload_bytes,overhead_bytes,heap_bytes\n");
+	} else {
+		printf("%-14s %-16s %10s %10s %10s %10s   (bytes per element)\n", "container", "payload", "n", "payload",
+		       "overhead", "heap");
+	}
+	for (auto &r : rows) {
+		if (csv) {
+			printf("%s,%s,%ld", r.container.c_str(), r.payload.c_str(), r.n);
+		} else {
+			printf("%-14s %-16s %10ld", r.container.c_str(), r.payload.c_str(), r.n);
+		}
+		print_cell(r.payload_bytes, csv);
+		print_cell(r.overhead_bytes, csv);
+		print_cell(r.heap_bytes, csv);
+		printf("\n");
+	}
+	return 0;
+}
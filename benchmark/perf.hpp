@@ -0,0 +1,166 @@
+// hardware performance counters for the benchmark harness, through linux perf_event_open
+// every event is opened on its own so that a VM or container missing some of them still reports the rest
+#ifndef SJTU_BENCH_PERF_HPP
+#define SJTU_BENCH_PERF_HPP
+
+#include <cerrno>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace bench {
+
+	class counters {
+	public:
+		static const int COUNT = 7;
+
+		static const char *name (int i) {
+			static const char *const names[COUNT] = {"cycles", "instructions", "l1d_miss", "llc_miss",
+			                                         "branch_miss", "dtlb_miss", "page_faults"};
+			return names[i];
+		}
+
+	private:
+		int fd[COUNT];
+		std::string reason;
+
+#ifdef __linux__
+		struct event {
+			std::uint32_t type;
+			std::uint64_t config;
+		};
+
+		static event describe (int i) {
+			const std::uint64_t read_miss = PERF_COUNT_HW_CACHE_OP_READ << 8 | PERF_COUNT_HW_CACHE_RESULT_MISS << 16;
+			const event events[COUNT] = {
+					{PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES},
+					{PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS},
+					{PERF_TYPE_HW_CACHE, PERF_COUNT_HW_CACHE_L1D | read_miss},
+					{PERF_TYPE_HW_CACHE, PERF_COUNT_HW_CACHE_LL | read_miss},
+					{PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES},
+					{PERF_TYPE_HW_CACHE, PERF_COUNT_HW_CACHE_DTLB | read_miss},
+					{PERF_TYPE_SOFTWARE, PERF_COUNT_SW_PAGE_FAULTS},
+			};
+			return events[i];
+		}
+
+		static int open (const event &e) {
+			perf_event_attr attr;
+			memset(&attr, 0, sizeof(attr));
+			attr.size = sizeof(attr);
+			attr.type = e.type;
+			attr.config = e.config;
+			attr.disabled = 1;
+			// user space only, which is all perf_event_paranoid = 2 allows
+			attr.exclude_kernel = 1;
+			attr.exclude_hv = 1;
+			attr.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+			return (int) syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0);
+		}
+#endif
+
+	public:
+		/**
+		 * enabled = false (--counters=off) opens nothing.
+		 */
+		explicit counters (bool enabled) {
+			for (int i = 0; i < COUNT; i++) {
+				fd[i] = -1;
+			}
+			if (!enabled) {
+				reason = "disabled";
+				return;
+			}
+#ifdef __linux__
+			int error = 0;
+			for (int i = 0; i < COUNT; i++) {
+				fd[i] = open(describe(i));
+				if (fd[i] < 0 && error == 0) {
+					error = errno;
+				}
+			}
+			if (error != 0) {
+				reason = std::string("perf_event_open: ") + strerror(error);
+			}
+#else
+			reason = "perf_event_open is linux only";
+#endif
+		}
+
+		counters (const counters &other) = delete;
+
+		counters &operator= (const counters &other) = delete;
+
+		~counters () {
+#ifdef __linux__
+			for (int i = 0; i < COUNT; i++) {
+				if (fd[i] >= 0) {
+					close(fd[i]);
+				}
+			}
+#endif
+		}
+
+		bool available (int i) const {
+			return fd[i] >= 0;
+		}
+
+		bool any () const {
+			for (int i = 0; i < COUNT; i++) {
+				if (fd[i] >= 0) {
+					return true;
+				}
+			}
+			return false;
+		}
+
+		// why some or all of the counters could not be opened, empty if they all were
+		const std::string &unavailable () const {
+			return reason;
+		}
+
+		void start () {
+#ifdef __linux__
+			for (int i = 0; i < COUNT; i++) {
+				if (fd[i] >= 0) {
+					ioctl(fd[i], PERF_EVENT_IOC_RESET, 0);
+					ioctl(fd[i], PERF_EVENT_IOC_ENABLE, 0);
+				}
+			}
+#endif
+		}
+
+		/**
+		 * add the counts since start() to total, scaled up when the kernel had to multiplex the counters.
+		 */
+		void stop (double total[COUNT]) {
+#ifdef __linux__
+			for (int i = 0; i < COUNT; i++) {
+				if (fd[i] >= 0) {
+					ioctl(fd[i], PERF_EVENT_IOC_DISABLE, 0);
+				}
+			}
+			for (int i = 0; i < COUNT; i++) {
+				std::uint64_t value[3];
+				if (fd[i] < 0 || read(fd[i], value, sizeof(value)) != (ssize_t) sizeof(value)) {
+					continue;
+				}
+				if (value[2] > 0) {
+					total[i] += (double) value[0] * ((double) value[1] / (double) value[2]);
+				}
+			}
+#else
+			(void) total;
+#endif
+		}
+	};
+
+}
+
+#endif
@@ -0,0 +1,241 @@
+// replay recorded map / deque traces (see trace.hpp) against every implementation in the tree and std
+// usage: replay trace... [--sizes / --reps / --warmup / --format / --filter / --clock / --counters as in bench.hpp]
+//        replay --generate=map|deque [--records=1000000] [--seed=N] out.trace    write a synthetic trace to try it on
+// every implementation must produce the same checksum from a trace before any of them is timed
+
+#include <cstdio>
+#include <cstdlib>
+#include <deque>
+#include <map>
+#include <string>
+#include <vector>
+// map first: its exceptions.hpp is the only one that declares InsertionFailure,
+// the other copies share the include guard and are skipped
+#include "../map/map.hpp"
+#include "../map/compact_map.hpp"
+#include "../map/unordered_map.hpp"
+#include "../deque/deque.hpp"
+#include "../deque/ring_deque.hpp"
+#include "bench.hpp"
+#include "trace.hpp"
+
+template<class Map>
+long long replay_map (Map &m, const trace::reader &t) {
+	typedef typename Map::value_type value_type;
+	long long observed = 0;
+	for (const trace::record *r = t.begin(); r != t.end(); ++r) {
+		switch (r->op) {
+			case trace::INSERT:
+				m.insert(value_type(r->arg, r->value));
+				break;
+			case trace::FIND: {
+				auto it = m.find(r->arg);
+				if (it != m.end()) {
+					observed += it->second;
+				}
+				break;
+			}
+			case trace::ERASE: {
+				auto it = m.find(r->arg);
+				if (it != m.end()) {
+					m.erase(it);
+				}
+				break;
+			}
+			case trace::ITERATE:
+				for (auto it = m.begin(); it != m.end(); ++it) {
+					observed += it->second;
+				}
+				break;
+			case trace::CLEAR:
+				m.clear();
+				break;
+		}
+	}
+	return observed + (long long) m.size();
+}
+
+// positions past the end are clamped and pops of an empty deque are skipped, so any trace replays
+template<class Deque>
+long long replay_deque (Deque &d, const trace::reader &t) {
+	long long observed = 0;
+	for (const trace::record *r = t.begin(); r != t.end(); ++r) {
+		size_t n = d.size();
+		size_t pos = r->arg < 0 ? 0 : (size_t) r->arg;
+		switch (r->op) {
+			case trace::PUSH_BACK:
+				d.push_back(r->value);
+				break;
+			case trace::PUSH_FRONT:
+				d.push_front(r->value);
+				break;
+			case trace::POP_BACK:
+				if (n > 0) {
+					observed += d.back();
+					d.pop_back();
+				}
+				break;
+			case trace::POP_FRONT:
+				if (n > 0) {
+					observed += d.front();
+					d.pop_front();
+				}
+				break;
+			case trace::INSERT_AT:
+				d.insert(d.begin() + (int) (pos > n ? n : pos), r->value);
+				break;
+			case trace::ERASE_AT:
+				if (n > 0) {
+					d.erase(d.begin() + (int) (pos >= n ? n - 1 : pos));
+				}
+				break;
+			case trace::AT:
+				if (n > 0) {
+					observed += d.at(pos >= n ? n - 1 : pos);
+				}
+				break;
+		}
+	}
+	return observed + (long long) d.size();
+}
+
+template<class Map>
+void run_map (bench::runner &run, const char *impl, const std::string &name, const trace::reader &t,
+              long long expected) {
+	Map check;
+	if (replay_map(check, t) != expected) {
+		fprintf(stderr, "%s: %s disagrees with std::map, not timed\n", name.c_str(), impl);
+		return;
+	}
+	long n = (long) t.size();
+	run.measure("map", impl, name, n, n, [] { return Map(); }, [&] (Map &m) {
+		bench::keep(replay_map(m, t));
+	});
+}
+
+template<class Deque>
+void run_deque (bench::runner &run, const char *impl, const std::string &name, const trace::reader &t,
+                long long expected) {
+	Deque check;
+	if (replay_deque(check, t) != expected) {
+		fprintf(stderr, "%s: %s disagrees with std::deque, not timed\n", name.c_str(), impl);
+		return;
+	}
+	long n = (long) t.size();
+	run.measure("deque", impl, name, n, n, [] { return Deque(); }, [&] (Deque &d) {
+		bench::keep(replay_deque(d, t));
+	});
+}
+
+// a service like mix: most lookups go to a small hot set of keys, a deque used mostly as a queue
+void generate (const std::string &container, long records, std::uint64_t seed, const std::string &path) {
+	bench::rng random(seed);
+	if (container == "map") {
+		trace::writer out(path, trace::MAP);
+		const long keys = records / 4 + 1, hot = keys / 20 + 1;
+		for (long i = 0; i < records; i++) {
+			std::uint64_t dice = random.below(100);
+			long long key = random.below(100) < 80 ? (long long) random.below(hot) : (long long) random.below(keys);
+			if (dice < 50) {
+				out.add(trace::FIND, key);
+			} else if (dice < 80) {
+				out.add(trace::INSERT, key, (std::int32_t) random.next());
+			} else {
+				out.add(trace::ERASE, key);
+			}
+			if (random.below(200000) == 0) {
+				out.add(trace::ITERATE);
+			}
+		}
+	} else if (container == "deque") {
+		trace::writer out(path, trace::DEQUE);
+		long size = 0;
+		for (long i = 0; i < records; i++) {
+			std::uint64_t dice = random.below(100);
+			std::int64_t pos = size == 0 ? 0 : (std::int64_t) random.below(size);
+			if (dice < 40) {
+				out.add(trace::PUSH_BACK, 0, (std::int32_t) random.next());
+				size++;
+			} else if (dice < 50) {
+				out.add(trace::PUSH_FRONT, 0, (std::int32_t) random.next());
+				size++;
+			} else if (dice < 85) {
+				out.add(trace::POP_FRONT);
+				size -= size > 0;
+			} else if (dice < 90) {
+				out.add(trace::POP_BACK);
+				size -= size > 0;
+			} else if (dice < 95) {
+				out.add(trace::AT, pos);
+			} else if (dice < 98) {
+				out.add(trace::INSERT_AT, pos, (std::int32_t) random.next());
+				size++;
+			} else {
+				out.add(trace::ERASE_AT, pos);
+				size -= size > 0;
+			}
+		}
+	} else {
+		fprintf(stderr, "--generate takes map or deque\n");
+		exit(1);
+	}
+}
+
+int main (int argc, char *argv[]) {
+	std::string generating;
+	long records = 1000000;
+	std::vector<std::string> files;
+	// the remaining options go to bench::parse
+	std::vector<char *> rest(1, argv[0]);
+	std::uint64_t seed = bench::options().seed;
+	for (int i = 1; i < argc; i++) {
+		std::string arg = argv[i];
+		if (arg.compare(0, 11, "--generate=") == 0) {
+			generating = arg.substr(11);
+		} else if (arg.compare(0, 10, "--records=") == 0) {
+			records = (long) atof(arg.c_str() + 10);
+		} else if (arg.compare(0, 2, "--") != 0) {
+			files.push_back(arg);
+		} else {
+			if (arg.compare(0, 7, "--seed=") == 0) {
+				seed = strtoull(arg.c_str() + 7, nullptr, 10);
+			}
+			rest.push_back(argv[i]);
+		}
+	}
+	if (!generating.empty()) {
+		if (files.size() != 1) {
+			fprintf(stderr, "--generate writes exactly one trace file\n");
+			return 1;
+		}
+		generate(generating, records, seed, files[0]);
+		return 0;
+	}
+	if (files.empty()) {
+		fprintf(stderr, "usage: replay trace... [bench options] | replay --generate=map|deque out.trace\n");
+		return 1;
+	}
+	bench::runner run(bench::parse((int) rest.size(), rest.data()));
+	for (auto &file : files) {
+		trace::reader t(file);
+		std::string name = file.substr(file.find_last_of('/') + 1);
+		if (t.container() == trace::MAP) {
+			std::map<long long, int> reference;
+			long long expected = replay_map(reference, t);
+			run_map<sjtu::map<long long, int>>(run, "sjtu::map", name, t, expected);
+			run_map<sjtu::compact_map<long long, int>>(run, "sjtu::compact_map", name, t, expected);
+			run_map<sjtu::unordered_map<long long, int>>(run, "sjtu::unordered_map", name, t, expected);
+			run_map<std::map<long long, int>>(run, "std::map", name, t, expected);
+		} else if (t.container() == trace::DEQUE) {
+			std::deque<int> reference;
+			long long expected = replay_deque(reference, t);
+			run_deque<sjtu::deque<int>>(run, "sjtu::deque", name, t, expected);
+			run_deque<sjtu::ring_deque<int>>(run, "sjtu::ring_deque", name, t, expected);
+			run_deque<std::deque<int>>(run, "std::deque", name, t, expected);
+		} else {
+			fprintf(stderr, "%s: unknown container %u\n", file.c_str(), (unsigned) t.container());
+		}
+	}
+	run.report();
+	return 0;
+}
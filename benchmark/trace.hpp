@@ -0,0 +1,306 @@
+// binary operation traces: record what a service does to a map or a deque, replay it against any implementation
+// a trace is a 32 byte header followed by fixed size 16 byte records, so a mapped file is read in place
+#ifndef SJTU_TRACE_HPP
+#define SJTU_TRACE_HPP
+
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define SJTU_TRACE_HAS_MMAP 1
+#endif
+
+namespace trace {
+
+	enum kind : std::uint32_t {
+		MAP = 1, DEQUE = 2
+	};
+
+	enum op : std::uint32_t {
+		// map: key in arg, value in value
+		INSERT = 1, FIND, ERASE, ITERATE, CLEAR,
+		// deque: position in arg, value in value
+		PUSH_BACK = 16, PUSH_FRONT, POP_BACK, POP_FRONT, INSERT_AT, ERASE_AT, AT
+	};
+
+	struct header {
+		char magic[8];
+		std::uint32_t version;
+		std::uint32_t container;
+		std::uint64_t records;
+		std::uint64_t reserved;
+	};
+
+	struct record {
+		std::uint32_t op;
+		std::int32_t value;
+		std::int64_t arg;
+	};
+
+	static_assert(sizeof(header) == 32 && sizeof(record) == 16, "the trace layout is fixed");
+
+	const char MAGIC[8] = {'S', 'J', 'T', 'U', 'T', 'R', 'C', '\0'};
+	const std::uint32_t VERSION = 1;
+
+	/**
+	 * appends records to a trace file, buffered; the record count in the header is written by close().
+	 */
+	class writer {
+	private:
+		FILE *file;
+		header head;
+		std::vector<record> buffer;
+
+		void flush () {
+			if (!buffer.empty() && fwrite(buffer.data(), sizeof(record), buffer.size(), file) != buffer.size()) {
+				throw std::runtime_error("trace: write failed");
+			}
+			buffer.clear();
+		}
+
+	public:
+		writer (const std::string &path, kind container) {
+			file = fopen(path.c_str(), "wb");
+			if (file == nullptr) {
+				throw std::runtime_error("trace: cannot create " + path);
+			}
+			memset(&head, 0, sizeof(head));
+			memcpy(head.magic, MAGIC, sizeof(MAGIC));
+			head.version = VERSION;
+			head.container = container;
+			fwrite(&head, sizeof(head), 1, file);
+			buffer.reserve(4096);
+		}
+
+		writer (const writer &other) = delete;
+
+		writer &operator= (const writer &other) = delete;
+
+		~writer () {
+			if (file != nullptr) {
+				close();
+			}
+		}
+
+		void add (op o, std::int64_t arg = 0, std::int32_t value = 0) {
+			record r;
+			r.op = o;
+			r.value = value;
+			r.arg = arg;
+			buffer.push_back(r);
+			head.records++;
+			if (buffer.size() == 4096) {
+				flush();
+			}
+		}
+
+		void close () {
+			flush();
+			fseek(file, 0, SEEK_SET);
+			fwrite(&head, sizeof(head), 1, file);
+			fclose(file);
+			file = nullptr;
+		}
+	};
+
+	/**
+	 * a whole trace, mapped read only where mmap exists and read into memory elsewhere.
+	 */
+	class reader {
+	private:
+		const header *head = nullptr;
+		const record *first = nullptr;
+		size_t length = 0;
+		// mapped bytes, or the copy when there is no mmap
+		void *base = nullptr;
+		size_t bytes = 0;
+		std::vector<char> copy;
+
+		void release () {
+#ifdef SJTU_TRACE_HAS_MMAP
+			if (base != nullptr) {
+				munmap(base, bytes);
+				base = nullptr;
+			}
+#endif
+		}
+
+	public:
+		explicit reader (const std::string &path) {
+#ifdef SJTU_TRACE_HAS_MMAP
+			int fd = open(path.c_str(), O_RDONLY);
+			if (fd < 0) {
+				throw std::runtime_error("trace: cannot open " + path);
+			}
+			struct stat st;
+			if (fstat(fd, &st) != 0 || (size_t) st.st_size < sizeof(header)) {
+				::close(fd);
+				throw std::runtime_error("trace: " + path + " is too short");
+			}
+			bytes = (size_t) st.st_size;
+			base = mmap(nullptr, bytes, PROT_READ, MAP_PRIVATE, fd, 0);
+			::close(fd);
+			if (base == MAP_FAILED) {
+				base = nullptr;
+				throw std::runtime_error("trace: cannot map " + path);
+			}
+			// replay reads front to back
+			madvise(base, bytes, MADV_SEQUENTIAL);
+			madvise(base, bytes, MADV_WILLNEED);
+			const char *data = (const char *) base;
+#else
+			FILE *file = fopen(path.c_str(), "rb");
+			if (file == nullptr) {
+				throw std::runtime_error("trace: cannot open " + path);
+			}
+			char chunk[1 << 16];
+			size_t n;
+			while ((n = fread(chunk, 1, sizeof(chunk), file)) > 0) {
+				copy.insert(copy.end(), chunk, chunk + n);
+			}
+			fclose(file);
+			if (copy.size() < sizeof(header)) {
+				throw std::runtime_error("trace: " + path + " is too short");
+			}
+			bytes = copy.size();
+			const char *data = copy.data();
+#endif
+			head = (const header *) data;
+			if (memcmp(head->magic, MAGIC, sizeof(MAGIC)) != 0 || head->version != VERSION) {
+				release();
+				throw std::runtime_error("trace: " + path + " is not a version 1 trace");
+			}
+			length = (size_t) head->records;
+			if (sizeof(header) + length * sizeof(record) > bytes) {
+				release();
+				throw std::runtime_error("trace: " + path + " is truncated");
+			}
+			first = (const record *) (data + sizeof(header));
+		}
+
+		reader (const reader &other) = delete;
+
+		reader &operator= (const reader &other) = delete;
+
+		~reader () {
+			release();
+		}
+
+		kind container () const {
+			return (kind) head->container;
+		}
+
+		const record *begin () const {
+			return first;
+		}
+
+		const record *end () const {
+			return first + length;
+		}
+
+		size_t size () const {
+			return length;
+		}
+	};
+
+	/**
+	 * forwards to Map and records every call, the keys and values must convert to integers.
+	 */
+	template<class Map>
+	class recording_map {
+	private:
+		Map &map;
+		writer &out;
+
+	public:
+		typedef typename Map::value_type value_type;
+
+		recording_map (Map &map, writer &out) : map(map), out(out) {}
+
+		auto insert (const value_type &kv) -> decltype(map.insert(kv)) {
+			out.add(INSERT, (std::int64_t) kv.first, (std::int32_t) kv.second);
+			return map.insert(kv);
+		}
+
+		template<class Key>
+		auto find (const Key &key) -> decltype(map.find(key)) {
+			out.add(FIND, (std::int64_t) key);
+			return map.find(key);
+		}
+
+		template<class Key>
+		void erase (const Key &key) {
+			out.add(ERASE, (std::int64_t) key);
+			auto it = map.find(key);
+			if (it != map.end()) {
+				map.erase(it);
+			}
+		}
+
+		void clear () {
+			out.add(CLEAR);
+			map.clear();
+		}
+	};
+
+	/**
+	 * forwards to Deque and records every call, the values must convert to integers.
+	 */
+	template<class Deque>
+	class recording_deque {
+	private:
+		Deque &deque;
+		writer &out;
+
+	public:
+		recording_deque (Deque &deque, writer &out) : deque(deque), out(out) {}
+
+		template<class T>
+		void push_back (const T &value) {
+			out.add(PUSH_BACK, 0, (std::int32_t) value);
+			deque.push_back(value);
+		}
+
+		template<class T>
+		void push_front (const T &value) {
+			out.add(PUSH_FRONT, 0, (std::int32_t) value);
+			deque.push_front(value);
+		}
+
+		void pop_back () {
+			out.add(POP_BACK);
+			deque.pop_back();
+		}
+
+		void pop_front () {
+			out.add(POP_FRONT);
+			deque.pop_front();
+		}
+
+		template<class T>
+		void insert (size_t pos, const T &value) {
+			out.add(INSERT_AT, (std::int64_t) pos, (std::int32_t) value);
+			deque.insert(deque.begin() + (int) pos, value);
+		}
+
+		void erase (size_t pos) {
+			out.add(ERASE_AT, (std::int64_t) pos);
+			deque.erase(deque.begin() + (int) pos);
+		}
+
+		auto at (size_t pos) -> decltype(deque.at(pos)) {
+			out.add(AT, (std::int64_t) pos);
+			return deque.at(pos);
+		}
+	};
+
+}
+
+#endif
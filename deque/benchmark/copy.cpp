@@ -0,0 +1,58 @@
+// copy construction and copy assignment throughput of sjtu::deque, std::deque as reference
+// usage: copy [elements]
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <deque>
+#include <string>
+#include "../deque.hpp"
+
+template<class F>
+double seconds (F f) {
+	auto begin = std::chrono::steady_clock::now();
+	f();
+	return std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+}
+
+template<class Deque, class Make>
+void run (const char *name, int n, Make make) {
+	Deque a;
+	for (int i = 0; i < n; i++) {
+		if (i & 1) {
+			a.push_back(make(i));
+		} else {
+			a.push_front(make(i));
+		}
+	}
+	const int rounds = 10;
+	size_t sink = 0;
+	double t_construct = seconds([&] {
+		for (int i = 0; i < rounds; i++) {
+			Deque b(a);
+			sink += b.size();
+		}
+	});
+	Deque c;
+	double t_assign = seconds([&] {
+		for (int i = 0; i < rounds; i++) {
+			c = a;
+			sink += c.size();
+		}
+	});
+	printf("  %-28s %12.1f %12.1f   (%zu)\n", name, rounds * (double) n / t_construct / 1e6,
+	       rounds * (double) n / t_assign / 1e6, sink % 10);
+}
+
+int main (int argc, char *argv[]) {
+	int n = argc > 1 ? atoi(argv[1]) : 1000000;
+	auto make_int = [] (int i) { return i; };
+	auto make_string = [] (int i) { return std::to_string(i); };
+	printf("n=%d, 10 copies each (million elements per second)\n", n);
+	printf("  %-28s %12s %12s\n", "", "construct", "assign");
+	run<sjtu::deque<int>>("sjtu::deque<int>", n, make_int);
+	run<std::deque<int>>("std::deque<int>", n, make_int);
+	run<sjtu::deque<std::string>>("sjtu::deque<string>", n, make_string);
+	run<std::deque<std::string>>("std::deque<string>", n, make_string);
+	return 0;
+}
@@ -0,0 +1,239 @@
+// a small fork-join scheduler over per-worker task queues, with a Chase-Lev deque or a mutex guarded sjtu::deque
+// usage: fork_join [workers] [fib n] [sum elements]
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "../deque.hpp"
+#include "../work_stealing_deque.hpp"
+
+struct task {
+	void (*run) (task *);
+	std::atomic<bool> done;
+
+	explicit task (void (*run) (task *)) : run(run), done(false) {}
+};
+
+// the same push / pop / steal interface as work_stealing_deque over a mutex
+class locked {
+private:
+	sjtu::deque<task *> q;
+	std::mutex lock;
+
+public:
+	void push (task *const &value) {
+		std::lock_guard<std::mutex> guard(lock);
+		q.push_back(value);
+	}
+
+	bool pop (task *&result) {
+		std::lock_guard<std::mutex> guard(lock);
+		if (q.empty()) {
+			return false;
+		}
+		result = q.back();
+		q.pop_back();
+		return true;
+	}
+
+	bool steal (task *&result) {
+		std::lock_guard<std::mutex> guard(lock);
+		if (q.empty()) {
+			return false;
+		}
+		result = q.front();
+		q.pop_front();
+		return true;
+	}
+};
+
+// the calling thread is worker 0, the others steal until the pool is destroyed
+template<class Queue>
+class pool {
+private:
+	std::vector<Queue *> queues;
+	std::vector<std::thread> threads;
+	std::atomic<bool> stop;
+	static thread_local int self;
+
+	bool find (task *&t) {
+		if (queues[self]->pop(t)) {
+			return true;
+		}
+		static thread_local unsigned seed = 12345u + self;
+		for (size_t i = 0; i < queues.size(); i++) {
+			seed = seed * 1103515245u + 12345u;
+			size_t victim = (seed >> 8) % queues.size();
+			if ((int) victim != self && queues[victim]->steal(t)) {
+				return true;
+			}
+		}
+		return false;
+	}
+
+	static void execute (task *t) {
+		t->run(t);
+		t->done.store(true, std::memory_order_release);
+	}
+
+public:
+	static pool *current;
+
+	explicit pool (int workers) : stop(false) {
+		for (int i = 0; i < workers; i++) {
+			queues.push_back(new Queue);
+		}
+		self = 0;
+		current = this;
+		for (int i = 1; i < workers; i++) {
+			threads.emplace_back([this, i] {
+				self = i;
+				task *t;
+				while (!stop.load(std::memory_order_relaxed)) {
+					if (find(t)) {
+						execute(t);
+					} else {
+						std::this_thread::yield();
+					}
+				}
+			});
+		}
+	}
+
+	~pool () {
+		stop = true;
+		for (auto &t : threads) {
+			t.join();
+		}
+		for (auto q : queues) {
+			delete q;
+		}
+	}
+
+	void spawn (task *t) {
+		queues[self]->push(t);
+	}
+
+	// run other tasks until t is done
+	void sync (task *t) {
+		task *other;
+		while (!t->done.load(std::memory_order_acquire)) {
+			if (find(other)) {
+				execute(other);
+			} else {
+				std::this_thread::yield();
+			}
+		}
+	}
+};
+
+template<class Queue>
+thread_local int pool<Queue>::self = 0;
+
+template<class Queue>
+pool<Queue> *pool<Queue>::current = nullptr;
+
+long long fib_serial (int n) {
+	return n < 2 ? n : fib_serial(n - 1) + fib_serial(n - 2);
+}
+
+const int FIB_CUTOFF = 12;
+
+template<class Queue>
+struct fib_task : task {
+	int n;
+	long long result;
+
+	explicit fib_task (int n) : task(&fib_task::run_fib), n(n), result(0) {}
+
+	static void run_fib (task *base) {
+		auto self = static_cast<fib_task *>(base);
+		if (self->n < FIB_CUTOFF) {
+			self->result = fib_serial(self->n);
+			return;
+		}
+		fib_task left(self->n - 1);
+		pool<Queue>::current->spawn(&left);
+		fib_task right(self->n - 2);
+		run_fib(&right);
+		pool<Queue>::current->sync(&left);
+		self->result = left.result + right.result;
+	}
+};
+
+const long long SUM_CUTOFF = 1 << 14;
+
+template<class Queue>
+struct sum_task : task {
+	const int *first;
+	long long n;
+	long long result;
+
+	sum_task (const int *first, long long n) : task(&sum_task::run_sum), first(first), n(n), result(0) {}
+
+	static void run_sum (task *base) {
+		auto self = static_cast<sum_task *>(base);
+		if (self->n <= SUM_CUTOFF) {
+			long long s = 0;
+			for (long long i = 0; i < self->n; i++) {
+				s += self->first[i] % 7;
+			}
+			self->result = s;
+			return;
+		}
+		long long half = self->n / 2;
+		sum_task left(self->first, half);
+		pool<Queue>::current->spawn(&left);
+		sum_task right(self->first + half, self->n - half);
+		run_sum(&right);
+		pool<Queue>::current->sync(&left);
+		self->result = left.result + right.result;
+	}
+};
+
+template<class F>
+double seconds (F f) {
+	auto begin = std::chrono::steady_clock::now();
+	f();
+	return std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+}
+
+template<class Queue>
+void run (const char *name, int workers, int n, const std::vector<int> &data) {
+	pool<Queue> p(workers);
+	fib_task<Queue> fib(n);
+	double t_fib = seconds([&] { fib_task<Queue>::run_fib(&fib); });
+	sum_task<Queue> sum(data.data(), (long long) data.size());
+	double t_sum = seconds([&] { sum_task<Queue>::run_sum(&sum); });
+	printf("  %-28s %10.3f %10.3f   (%lld %lld)\n", name, t_fib, t_sum, fib.result, sum.result);
+}
+
+int main (int argc, char *argv[]) {
+	int hardware = (int) std::thread::hardware_concurrency();
+	int workers = argc > 1 ? atoi(argv[1]) : (hardware > 1 ? hardware : 2);
+	int n = argc > 2 ? atoi(argv[2]) : 36;
+	int elements = argc > 3 ? atoi(argv[3]) : 50000000;
+	std::vector<int> data(elements);
+	unsigned seed = 20190401;
+	for (auto &x : data) {
+		seed = seed * 1103515245u + 12345u;
+		x = (int) (seed >> 8);
+	}
+	printf("%d workers, fib(%d), sum of %d ints (seconds)\n", workers, n, elements);
+	printf("  %-28s %10s %10s\n", "", "fib", "sum");
+	long long fib_result = 0, sum_result = 0;
+	double t_fib = seconds([&] { fib_result = fib_serial(n); });
+	double t_sum = seconds([&] {
+		for (auto x : data) {
+			sum_result += x % 7;
+		}
+	});
+	printf("  %-28s %10.3f %10.3f   (%lld %lld)\n", "serial", t_fib, t_sum, fib_result, sum_result);
+	run<sjtu::work_stealing_deque<task *>>("work_stealing_deque", workers, n, data);
+	run<locked>("mutex + sjtu::deque", workers, n, data);
+	return 0;
+}
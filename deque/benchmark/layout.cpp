@@ -0,0 +1,64 @@
+// element access, push / pop and full scans on sjtu::deque, std::deque as reference
+// usage: layout [elements]
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <deque>
+#include "../deque.hpp"
+
+template<class F>
+double seconds (F f) {
+	auto begin = std::chrono::steady_clock::now();
+	f();
+	return std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+}
+
+template<class Deque>
+void run (const char *name, int n) {
+	Deque a;
+	unsigned seed = 20190401;
+	long long sink = 0;
+	double t_push = seconds([&] {
+		for (int i = 0; i < n; i++) {
+			if (i & 1) {
+				a.push_back(i);
+			} else {
+				a.push_front(i);
+			}
+		}
+	});
+	const int lookups = 200000;
+	double t_at = seconds([&] {
+		for (int i = 0; i < lookups; i++) {
+			seed = seed * 1103515245u + 12345u;
+			sink += a.at((seed >> 8) % n);
+		}
+	});
+	double t_scan = seconds([&] {
+		for (int round = 0; round < 10; round++) {
+			for (auto it = a.begin(); it != a.end(); ++it) {
+				sink += *it;
+			}
+		}
+	});
+	double t_pop = seconds([&] {
+		for (int i = 0; i < n; i++) {
+			if (i & 1) {
+				a.pop_back();
+			} else {
+				a.pop_front();
+			}
+		}
+	});
+	printf("  %-12s %12.3f %12.3f %12.3f %12.3f   (%lld)\n", name, t_push, t_at, t_scan, t_pop, sink % 10);
+}
+
+int main (int argc, char *argv[]) {
+	int n = argc > 1 ? atoi(argv[1]) : 1000000;
+	printf("n=%d, n pushes, 200000 at(), 10 full scans, n pops (seconds)\n", n);
+	printf("  %-12s %12s %12s %12s %12s\n", "", "push", "at", "scan", "pop");
+	run<sjtu::deque<int>>("sjtu::deque", n);
+	run<std::deque<int>>("std::deque", n);
+	return 0;
+}
@@ -0,0 +1,71 @@
+// loading a large sequence of ints into sjtu::deque, std::deque as reference
+// usage: load [elements]
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <deque>
+#include <vector>
+#include "../deque.hpp"
+
+template<class F>
+double seconds (F f) {
+	auto begin = std::chrono::steady_clock::now();
+	f();
+	return std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+}
+
+int main (int argc, char *argv[]) {
+	int n = argc > 1 ? atoi(argv[1]) : 10000000;
+	std::vector<int> source(n);
+	unsigned seed = 20190401;
+	for (int i = 0; i < n; i++) {
+		seed = seed * 1103515245u + 12345u;
+		source[i] = (int) (seed >> 8);
+	}
+	long long sink = 0;
+	printf("n=%d (seconds)\n", n);
+	double t = seconds([&] {
+		sjtu::deque<int> a;
+		for (int i = 0; i < n; i++) {
+			a.push_back(source[i]);
+		}
+		sink += a.back();
+	});
+	printf("  %-36s %8.3f\n", "sjtu::deque push_back loop", t);
+	t = seconds([&] {
+		sjtu::deque<int> a(source.begin(), source.end());
+		sink += a.back();
+	});
+	printf("  %-36s %8.3f\n", "sjtu::deque range constructor", t);
+	t = seconds([&] {
+		sjtu::deque<int> a;
+		a.append(source.begin(), source.begin() + n / 2);
+		a.prepend(source.begin() + n / 2, source.end());
+		sink += a.back();
+	});
+	printf("  %-36s %8.3f\n", "sjtu::deque append + prepend", t);
+	t = seconds([&] {
+		sjtu::deque<int> a;
+		a.push_back(0);
+		a.push_back(0);
+		a.insert(a.begin() + 1, source.begin(), source.end());
+		sink += a.back();
+	});
+	printf("  %-36s %8.3f\n", "sjtu::deque range insert", t);
+	t = seconds([&] {
+		std::deque<int> a;
+		for (int i = 0; i < n; i++) {
+			a.push_back(source[i]);
+		}
+		sink += a.back();
+	});
+	printf("  %-36s %8.3f\n", "std::deque push_back loop", t);
+	t = seconds([&] {
+		std::deque<int> a(source.begin(), source.end());
+		sink += a.back();
+	});
+	printf("  %-36s %8.3f\n", "std::deque range constructor", t);
+	printf("(%lld)\n", sink % 10);
+	return 0;
+}
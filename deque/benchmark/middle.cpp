@@ -0,0 +1,51 @@
+// inserts and erases at random positions of a large sjtu::deque, std::deque as reference
+// usage: middle [elements] [operations]
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <deque>
+#include "../deque.hpp"
+
+template<class F>
+double seconds (F f) {
+	auto begin = std::chrono::steady_clock::now();
+	f();
+	return std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+}
+
+template<class Deque>
+void run (const char *name, int n, int ops) {
+	Deque a;
+	for (int i = 0; i < n; i++) {
+		a.push_back(i);
+	}
+	unsigned seed = 20190401;
+	double t_insert = seconds([&] {
+		for (int i = 0; i < ops; i++) {
+			seed = seed * 1103515245u + 12345u;
+			a.insert(a.begin() + (int) ((seed >> 8) % (a.size() + 1)), i);
+		}
+	});
+	double t_erase = seconds([&] {
+		for (int i = 0; i < ops; i++) {
+			seed = seed * 1103515245u + 12345u;
+			a.erase(a.begin() + (int) ((seed >> 8) % a.size()));
+		}
+	});
+	long long sink = 0;
+	for (auto it = a.begin(); it != a.end(); ++it) {
+		sink += *it;
+	}
+	printf("  %-12s %12.0f %12.0f   (%lld)\n", name, ops / t_insert, ops / t_erase, sink % 10);
+}
+
+int main (int argc, char *argv[]) {
+	int n = argc > 1 ? atoi(argv[1]) : 1000000;
+	int ops = argc > 2 ? atoi(argv[2]) : 20000;
+	printf("n=%d, %d inserts then %d erases at random positions (operations per second)\n", n, ops, ops);
+	printf("  %-12s %12s %12s\n", "", "insert", "erase");
+	run<sjtu::deque<int>>("sjtu::deque", n, ops);
+	run<std::deque<int>>("std::deque", n, ops);
+	return 0;
+}
@@ -0,0 +1,71 @@
+// queue style workloads on sjtu::deque, sjtu::ring_deque and std::deque
+// usage: queue [elements]
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <deque>
+#include "../deque.hpp"
+#include "../ring_deque.hpp"
+
+template<class F>
+double seconds (F f) {
+	auto begin = std::chrono::steady_clock::now();
+	f();
+	return std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+}
+
+template<class Deque>
+void run (const char *name, int n) {
+	Deque a;
+	unsigned seed = 20190401;
+	long long sink = 0;
+	// a bounded fifo: keep about 1000 elements in flight while n pass through
+	double t_fifo = seconds([&] {
+		for (int i = 0; i < n; i++) {
+			a.push_back(i);
+			if (i >= 1000) {
+				sink += a.front();
+				a.pop_front();
+			}
+		}
+		while (!a.empty()) {
+			a.pop_front();
+		}
+	});
+	double t_ends = seconds([&] {
+		for (int i = 0; i < n; i++) {
+			if (i & 1) {
+				a.push_back(i);
+			} else {
+				a.push_front(i);
+			}
+		}
+	});
+	double t_at = seconds([&] {
+		for (int i = 0; i < n; i++) {
+			seed = seed * 1103515245u + 12345u;
+			sink += a[(seed >> 8) % n];
+		}
+	});
+	double t_drain = seconds([&] {
+		for (int i = 0; i < n; i++) {
+			if (i & 1) {
+				a.pop_back();
+			} else {
+				a.pop_front();
+			}
+		}
+	});
+	printf("  %-16s %10.3f %10.3f %10.3f %10.3f   (%lld)\n", name, t_fifo, t_ends, t_at, t_drain, sink % 10);
+}
+
+int main (int argc, char *argv[]) {
+	int n = argc > 1 ? atoi(argv[1]) : 1000000;
+	printf("n=%d (seconds)\n", n);
+	printf("  %-16s %10s %10s %10s %10s\n", "", "fifo", "push ends", "[]", "pop ends");
+	run<sjtu::deque<int>>("sjtu::deque", n);
+	run<sjtu::ring_deque<int>>("sjtu::ring_deque", n);
+	run<std::deque<int>>("std::deque", n);
+	return 0;
+}
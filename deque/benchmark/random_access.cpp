@@ -0,0 +1,65 @@
+// random access iteration patterns on sjtu::deque, std::deque as reference
+// usage: random_access [elements]
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <deque>
+#include "../deque.hpp"
+
+template<class F>
+double seconds (F f) {
+	auto begin = std::chrono::steady_clock::now();
+	f();
+	return std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+}
+
+template<class Deque>
+void run (const char *name, int n) {
+	Deque a;
+	unsigned seed = 20190401;
+	for (int i = 0; i < n; i++) {
+		seed = seed * 1103515245u + 12345u;
+		a.push_back((int) (seed >> 8));
+	}
+	long long sink = 0;
+	const int jumps = 200000;
+	double t_jump = seconds([&] {
+		auto it = a.begin();
+		int pos = 0;
+		for (int i = 0; i < jumps; i++) {
+			seed = seed * 1103515245u + 12345u;
+			int target = (seed >> 8) % n;
+			it = it + (target - pos);
+			pos = target;
+			sink += *it;
+		}
+	});
+	double t_distance = seconds([&] {
+		for (int i = 0; i < jumps; i++) {
+			seed = seed * 1103515245u + 12345u;
+			sink += (a.begin() + (int) ((seed >> 8) % n)) - a.begin();
+		}
+	});
+	double t_sort = seconds([&] {
+		std::sort(a.begin(), a.end());
+	});
+	double t_search = seconds([&] {
+		for (int i = 0; i < jumps; i++) {
+			seed = seed * 1103515245u + 12345u;
+			sink += std::lower_bound(a.begin(), a.end(), (int) (seed >> 8)) - a.begin();
+		}
+	});
+	printf("  %-12s %12.3f %12.3f %12.3f %12.3f   (%lld)\n", name, t_jump, t_distance, t_sort, t_search,
+	       sink % 10);
+}
+
+int main (int argc, char *argv[]) {
+	int n = argc > 1 ? atoi(argv[1]) : 100000;
+	printf("n=%d, 200000 jumps / distances / lower_bounds, one std::sort (seconds)\n", n);
+	printf("  %-12s %12s %12s %12s %12s\n", "", "it + k", "it - it", "std::sort", "lower_bound");
+	run<sjtu::deque<int>>("sjtu::deque", n);
+	run<std::deque<int>>("std::deque", n);
+	return 0;
+}
@@ -0,0 +1,102 @@
+// two thread hand-off through sjtu::spsc_queue and through mutex guarded deques
+// usage: spsc [items] [round trips]
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "../deque.hpp"
+#include "../ring_deque.hpp"
+#include "../spsc_queue.hpp"
+
+// the same push / pop interface over a deque and a mutex
+template<class Deque>
+class locked {
+private:
+	Deque q;
+	std::mutex lock;
+
+public:
+	void push (const int &value) {
+		std::lock_guard<std::mutex> guard(lock);
+		q.push_back(value);
+	}
+
+	bool pop (int &result) {
+		std::lock_guard<std::mutex> guard(lock);
+		if (q.empty()) {
+			return false;
+		}
+		result = q.front();
+		q.pop_front();
+		return true;
+	}
+};
+
+template<class Queue>
+double throughput (int n) {
+	Queue q;
+	long long sink = 0;
+	auto begin = std::chrono::steady_clock::now();
+	std::thread producer([&] {
+		for (int i = 0; i < n; i++) {
+			q.push(i);
+		}
+	});
+	int result;
+	for (int i = 0; i < n; i++) {
+		while (!q.pop(result)) {
+			std::this_thread::yield();
+		}
+		sink += result;
+	}
+	producer.join();
+	double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+	return sink == (long long) n * (n - 1) / 2 ? n / seconds / 1e6 : -1;
+}
+
+// one message to an echo thread and back, in nanoseconds
+template<class Queue>
+void latency (const char *name, int trips) {
+	Queue there, back;
+	std::thread echo([&] {
+		int value;
+		for (int i = 0; i < trips; i++) {
+			while (!there.pop(value)) {
+				std::this_thread::yield();
+			}
+			back.push(value);
+		}
+	});
+	std::vector<double> samples;
+	int value;
+	for (int i = 0; i < trips; i++) {
+		auto begin = std::chrono::steady_clock::now();
+		there.push(i);
+		while (!back.pop(value)) {
+			std::this_thread::yield();
+		}
+		samples.push_back(std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - begin).count());
+	}
+	echo.join();
+	std::sort(samples.begin(), samples.end());
+	printf("  %-28s %12.0f %12.0f\n", name, samples[samples.size() / 2], samples[samples.size() * 99 / 100]);
+}
+
+int main (int argc, char *argv[]) {
+	int n = argc > 1 ? atoi(argv[1]) : 10000000;
+	int trips = argc > 2 ? atoi(argv[2]) : 100000;
+	printf("%d ints from one thread to another (million items per second)\n", n);
+	printf("  %-28s %12.2f\n", "sjtu::spsc_queue", throughput<sjtu::spsc_queue<int>>(n));
+	printf("  %-28s %12.2f\n", "mutex + sjtu::deque", throughput<locked<sjtu::deque<int>>>(n));
+	printf("  %-28s %12.2f\n", "mutex + sjtu::ring_deque", throughput<locked<sjtu::ring_deque<int>>>(n));
+	printf("%d round trips (nanoseconds)\n", trips);
+	printf("  %-28s %12s %12s\n", "", "median", "p99");
+	latency<sjtu::spsc_queue<int>>("sjtu::spsc_queue", trips);
+	latency<locked<sjtu::deque<int>>>("mutex + sjtu::deque", trips);
+	latency<locked<sjtu::ring_deque<int>>>("mutex + sjtu::ring_deque", trips);
+	return 0;
+}
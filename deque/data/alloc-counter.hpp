@@ -0,0 +1,208 @@
+// counts every heap allocation of a test, so a test can require that an operation never allocates.
+// it replaces the global operator new / delete and, on glibc, interposes malloc, calloc, realloc and free,
+// so include it in exactly one translation unit of the test.
+// AddressSanitizer owns malloc and new, under it nothing is replaced and its malloc and free hooks do the counting.
+#ifndef ALLOC_COUNTER_HPP
+#define ALLOC_COUNTER_HPP
+
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+
+namespace alloc_counter {
+
+struct snapshot {
+	long long allocations;
+	long long frees;
+	long long bytes;
+};
+
+inline std::atomic<long long> &allocations() { static std::atomic<long long> n(0); return n; }
+inline std::atomic<long long> &frees() { static std::atomic<long long> n(0); return n; }
+inline std::atomic<long long> &bytes() { static std::atomic<long long> n(0); return n; }
+
+inline void allocated(size_t size) {
+	allocations().fetch_add(1, std::memory_order_relaxed);
+	bytes().fetch_add((long long) size, std::memory_order_relaxed);
+}
+
+inline void freed() {
+	frees().fetch_add(1, std::memory_order_relaxed);
+}
+
+inline snapshot now() {
+	snapshot s;
+	s.allocations = allocations().load(std::memory_order_relaxed);
+	s.frees = frees().load(std::memory_order_relaxed);
+	s.bytes = bytes().load(std::memory_order_relaxed);
+	return s;
+}
+
+/**
+ * the allocations made since the scope was entered.
+ */
+class scope {
+private:
+	snapshot begin;
+public:
+	scope() : begin(now()) {}
+	snapshot since() const {
+		snapshot s = now();
+		s.allocations -= begin.allocations;
+		s.frees -= begin.frees;
+		s.bytes -= begin.bytes;
+		return s;
+	}
+};
+
+/**
+ * run f and return the number of allocations it made.
+ */
+template<class F>
+long long count(F f) {
+	scope s;
+	f();
+	return s.since().allocations;
+}
+
+}
+
+/**
+ * prints "name: ok" or "name: FAIL (k allocations)", the answer file only has the former.
+ */
+#define EXPECT_NO_ALLOC(name, statement) do { \
+	long long alloc_counter_n = alloc_counter::count([&] { statement; }); \
+	if (alloc_counter_n == 0) { \
+		printf("%s: ok\n", name); \
+	} else { \
+		printf("%s: FAIL (%lld allocations)\n", name, alloc_counter_n); \
+	} \
+} while (0)
+
+#if defined(__has_feature)
+#if __has_feature(address_sanitizer)
+#define ALLOC_COUNTER_ASAN
+#endif
+#endif
+#if defined(__SANITIZE_ADDRESS__)
+#define ALLOC_COUNTER_ASAN
+#endif
+
+#if defined(ALLOC_COUNTER_ASAN)
+// declared by <sanitizer/allocator_interface.h>, which not every compiler ships
+extern "C" int __sanitizer_install_malloc_and_free_hooks(void (*malloc_hook)(const volatile void *, size_t),
+                                                         void (*free_hook)(const volatile void *));
+
+namespace alloc_counter {
+
+inline void asan_malloc(const volatile void *, size_t size) {
+	allocated(size);
+}
+
+inline void asan_free(const volatile void *p) {
+	if (p != nullptr) {
+		freed();
+	}
+}
+
+// installed before main runs; realloc reaches both hooks, as it does the glibc interposition below
+static const int asan_hooks = __sanitizer_install_malloc_and_free_hooks(asan_malloc, asan_free);
+
+}
+#elif defined(__GLIBC__)
+extern "C" {
+void *__libc_malloc(size_t size);
+void *__libc_calloc(size_t n, size_t size);
+void *__libc_realloc(void *p, size_t size);
+void __libc_free(void *p);
+
+// the executable's definitions take precedence over libc's, for libstdc++ and libc's own callers as well
+void *malloc(size_t size) {
+	alloc_counter::allocated(size);
+	return __libc_malloc(size);
+}
+
+void *calloc(size_t n, size_t size) {
+	alloc_counter::allocated(n * size);
+	return __libc_calloc(n, size);
+}
+
+void *realloc(void *p, size_t size) {
+	if (size != 0) {
+		alloc_counter::allocated(size);
+	}
+	if (p != nullptr) {
+		alloc_counter::freed();
+	}
+	return __libc_realloc(p, size);
+}
+
+void free(void *p) {
+	if (p != nullptr) {
+		alloc_counter::freed();
+	}
+	__libc_free(p);
+}
+}
+
+inline void *alloc_counter_new(size_t size) {
+	void *p = __libc_malloc(size == 0 ? 1 : size);
+	if (p == nullptr) {
+		throw std::bad_alloc();
+	}
+	alloc_counter::allocated(size);
+	return p;
+}
+
+inline void alloc_counter_delete(void *p) {
+	if (p != nullptr) {
+		alloc_counter::freed();
+	}
+	__libc_free(p);
+}
+#else
+inline void *alloc_counter_new(size_t size) {
+	void *p = std::malloc(size == 0 ? 1 : size);
+	if (p == nullptr) {
+		throw std::bad_alloc();
+	}
+	alloc_counter::allocated(size);
+	return p;
+}
+
+inline void alloc_counter_delete(void *p) {
+	if (p != nullptr) {
+		alloc_counter::freed();
+	}
+	std::free(p);
+}
+#endif
+
+// ASan's own operator new and delete reach its hooks
+#if !defined(ALLOC_COUNTER_ASAN)
+void *operator new(size_t size) { return alloc_counter_new(size); }
+void *operator new[](size_t size) { return alloc_counter_new(size); }
+void *operator new(size_t size, const std::nothrow_t &) noexcept {
+	try {
+		return alloc_counter_new(size);
+	} catch (...) {
+		return nullptr;
+	}
+}
+void *operator new[](size_t size, const std::nothrow_t &) noexcept {
+	try {
+		return alloc_counter_new(size);
+	} catch (...) {
+		return nullptr;
+	}
+}
+void operator delete(void *p) noexcept { alloc_counter_delete(p); }
+void operator delete[](void *p) noexcept { alloc_counter_delete(p); }
+void operator delete(void *p, size_t) noexcept { alloc_counter_delete(p); }
+void operator delete[](void *p, size_t) noexcept { alloc_counter_delete(p); }
+void operator delete(void *p, const std::nothrow_t &) noexcept { alloc_counter_delete(p); }
+void operator delete[](void *p, const std::nothrow_t &) noexcept { alloc_counter_delete(p); }
+#endif
+
+#endif
@@ -0,0 +1,85 @@
+// deque: range construction, assign, append, prepend and range insert checked against std::deque
+
+#include <iostream>
+#include <cstdio>
+#include <deque>
+#include <list>
+#include <vector>
+#include "../../deque.hpp"
+#include "../../exceptions.hpp"
+
+long long aa = 13131, bb = 5353, MOD = (long long) (1e9 + 7), now = 1;
+
+int rand () {
+	for (int i = 1; i < 3; i++)
+		now = (now * aa + bb) % MOD;
+	return now;
+}
+
+template<class A, class B>
+bool equal (A &a, B &b) {
+	if (a.size() != b.size()) return false;
+	size_t i = 0;
+	for (auto it = a.begin(); it != a.end(); ++it, ++i) {
+		if (*it != b[i] || a[i] != b[i]) return false;
+	}
+	return true;
+}
+
+int main () {
+	std::deque<int> ref;
+	sjtu::deque<int> q;
+	bool ok = true;
+	for (int round = 0; round < 3000 && ok; round++) {
+		std::vector<int> v(rand() % (round % 50 == 0 ? 5000 : 40));
+		for (auto &x : v) x = rand();
+		// a forward range that is not random access
+		std::list<int> l(v.begin(), v.end());
+		int op = rand() % 6;
+		if (op == 0) {
+			q.append(l.begin(), l.end());
+			ref.insert(ref.end(), v.begin(), v.end());
+		} else if (op == 1) {
+			q.prepend(v.begin(), v.end());
+			ref.insert(ref.begin(), v.begin(), v.end());
+		} else if (op == 2) {
+			int pos = rand() % (ref.size() + 1);
+			auto it = q.insert(q.begin() + pos, l.begin(), l.end());
+			ref.insert(ref.begin() + pos, v.begin(), v.end());
+			if (it - q.begin() != pos) ok = false;
+		} else if (op == 3 && !ref.empty()) {
+			int k = rand() % 60;
+			for (int i = 0; i < k && !ref.empty(); i++) {
+				int pos = rand() % ref.size();
+				q.erase(q.begin() + pos);
+				ref.erase(ref.begin() + pos);
+			}
+		} else if (op == 4 && round % 97 == 0) {
+			q.assign(v.begin(), v.end());
+			ref.assign(v.begin(), v.end());
+		} else {
+			for (int i = 0; i < 20; i++) {
+				if (rand() & 1) q.push_front(i), ref.push_front(i);
+				else q.push_back(i), ref.push_back(i);
+			}
+		}
+		ok = ok && equal(q, ref);
+	}
+	printf("range operations: %s\n", ok ? "Accept" : "Wrong Answer");
+	sjtu::deque<int> c(ref.begin(), ref.end());
+	printf("range constructor: %s\n", equal(c, ref) ? "Accept" : "Wrong Answer");
+	// one element at a time, prepend must pack blocks as tightly as push_front
+	sjtu::deque<int> one, pushed;
+	for (int i = 0; i < 100000; i++) {
+		one.prepend(&i, &i + 1);
+		pushed.push_front(i);
+	}
+	bool packed = equal(one, pushed) && one.memory_usage().overhead == pushed.memory_usage().overhead;
+	printf("prepend one by one: %s\n", packed ? "Accept" : "Wrong Answer");
+	int thrown = 0;
+	sjtu::deque<int> other;
+	try { q.insert(other.begin(), ref.begin(), ref.end()); } catch (sjtu::invalid_iterator) { thrown++; }
+	try { q.insert(q.end() + 1, ref.begin(), ref.end()); } catch (sjtu::invalid_iterator) { thrown++; }
+	printf("throw: %s\n", thrown == 2 ? "Accept" : "Wrong Answer");
+	return 0;
+}
@@ -0,0 +1,66 @@
+// work_stealing_deque: the owner pushes and pops while thieves steal, every item must be taken exactly once
+
+#include <iostream>
+#include <cstdio>
+#include <atomic>
+#include <thread>
+#include <vector>
+#include "../../work_stealing_deque.hpp"
+
+void test1 () {
+	printf("test1: single thread                  ");
+	sjtu::work_stealing_deque<int> q;
+	bool ok = q.empty();
+	int x;
+	// grows past the initial capacity several times
+	for (int i = 0; i < 10000; i++) q.push(i);
+	ok = ok && q.size() == 10000;
+	ok = ok && q.steal(x) && x == 0;
+	for (int i = 9999; i >= 5000; i--) ok = ok && q.pop(x) && x == i;
+	for (int i = 1; i < 5000; i++) ok = ok && q.steal(x) && x == i;
+	ok = ok && !q.pop(x) && !q.steal(x) && q.empty();
+	q.push(7);
+	ok = ok && q.pop(x) && x == 7 && !q.pop(x);
+	puts(ok ? "Accept" : "Wrong Answer");
+}
+
+void test2 () {
+	printf("test2: owner and thieves              ");
+	const int N = 1000000, THIEVES = 3;
+	sjtu::work_stealing_deque<int> q;
+	std::vector<std::atomic<int>> taken(N);
+	for (auto &t : taken) t = 0;
+	std::atomic<bool> done(false);
+	std::vector<std::thread> thieves;
+	for (int k = 0; k < THIEVES; k++) {
+		thieves.emplace_back([&] {
+			int x;
+			while (!done.load()) {
+				if (q.steal(x)) taken[x]++;
+				else std::this_thread::yield();
+			}
+		});
+	}
+	int x, next = 0;
+	while (next < N) {
+		// bursts of pushes followed by a few pops, so that the deque grows and shrinks
+		for (int i = 0; i < 64 && next < N; i++) q.push(next++);
+		for (int i = 0; i < 48; i++) {
+			if (q.pop(x)) taken[x]++;
+		}
+	}
+	while (q.pop(x)) taken[x]++;
+	done = true;
+	for (auto &t : thieves) t.join();
+	bool ok = true;
+	for (int i = 0; i < N; i++) {
+		if (taken[i] != 1) ok = false;
+	}
+	puts(ok ? "Accept" : "Wrong Answer");
+}
+
+int main () {
+	test1();
+	test2();
+	return 0;
+}
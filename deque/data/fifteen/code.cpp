@@ -0,0 +1,81 @@
+// ring_deque: insert and erase in the middle of a type that can be constructed but never assigned
+
+#include <iostream>
+#include <cstdio>
+#include <list>
+#include <string>
+#include "../../ring_deque.hpp"
+#include "../../exceptions.hpp"
+
+long long aa = 13131, bb = 5353, MOD = (long long) (1e9 + 7), now = 1;
+
+int rand () {
+	for (int i = 1; i < 3; i++)
+		now = (now * aa + bb) % MOD;
+	return now;
+}
+
+// a const member: copy and move construction only, every live object is counted
+class T {
+public:
+	static int counter;
+	const std::string s;
+	T (int x) : s(std::to_string(x)) { counter++; }
+	T (const T &other) : s(other.s) { counter++; }
+	T (T &&other) : s(std::move(const_cast<std::string &>(other.s))) { counter++; }
+	T &operator= (const T &other) = delete;
+	~T () { counter--; }
+	bool operator!= (const T &other) const { return s != other.s; }
+};
+
+int T::counter = 0;
+
+// std::list, because std::deque::insert needs an assignable type too
+bool equal (sjtu::ring_deque<T> &a, std::list<T> &b) {
+	if (a.size() != b.size()) return false;
+	size_t i = 0;
+	for (auto it = b.begin(); it != b.end(); ++it, ++i) {
+		if (a[i] != *it) return false;
+	}
+	return true;
+}
+
+int main () {
+	bool ok = true;
+	{
+		sjtu::ring_deque<T> q;
+		std::list<T> ref;
+		for (int round = 0; round < 20000 && ok; round++) {
+			int op = rand() % 4;
+			if (op < 2 || ref.empty()) {
+				int pos = rand() % (ref.size() + 1);
+				auto jt = ref.begin();
+				for (int i = 0; i < pos; i++) ++jt;
+				ref.insert(jt, T(round));
+				auto it = q.insert(q.begin() + pos, T(round));
+				if (it - q.begin() != pos) ok = false;
+			} else if (op == 2) {
+				int pos = rand() % ref.size();
+				auto jt = ref.begin();
+				for (int i = 0; i < pos; i++) ++jt;
+				ref.erase(jt);
+				auto it = q.erase(q.begin() + pos);
+				if (it - q.begin() != pos) ok = false;
+			} else {
+				// the value is one of the elements that move
+				int pos = rand() % ref.size(), from = rand() % ref.size();
+				auto jt = ref.begin(), kt = ref.begin();
+				for (int i = 0; i < pos; i++) ++jt;
+				for (int i = 0; i < from; i++) ++kt;
+				ref.insert(jt, *kt);
+				q.insert(q.begin() + pos, q[from]);
+			}
+			if (round % 100 == 0) ok = ok && equal(q, ref);
+		}
+		ok = ok && equal(q, ref);
+		printf("size: %d\n", (int) q.size());
+	}
+	printf("%s\n", ok ? "Accept" : "Wrong Answer");
+	printf("live objects: %d\n", T::counter);
+	return 0;
+}
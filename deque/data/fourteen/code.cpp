@@ -0,0 +1,82 @@
+// deque: split_at, splice, concat and moving whole deques never copy an element
+
+#include <iostream>
+#include <cstdio>
+#include <deque>
+#include <utility>
+#include "../../deque.hpp"
+#include "../../exceptions.hpp"
+
+class T {
+public:
+	static long copies, moves;
+	int x;
+	T (int x) : x(x) {}
+	T (const T &other) : x(other.x) { copies++; }
+	T (T &&other) : x(other.x) { moves++; }
+	T &operator= (const T &other) {
+		x = other.x;
+		copies++;
+		return *this;
+	}
+	T &operator= (T &&other) {
+		x = other.x;
+		moves++;
+		return *this;
+	}
+	bool operator!= (const T &other) const { return x != other.x; }
+};
+
+long T::copies = 0, T::moves = 0;
+
+template<class A, class B>
+bool equal (A &a, B &b) {
+	if (a.size() != b.size()) return false;
+	size_t i = 0;
+	for (auto it = a.begin(); it != a.end(); ++it, ++i) {
+		if (*it != b[i]) return false;
+	}
+	return true;
+}
+
+sjtu::deque<T> tail_of (sjtu::deque<T> &d, size_t index) {
+	sjtu::deque<T> rest = d.split_at(index);
+	return rest;
+}
+
+int main () {
+	const int N = 20000;
+	sjtu::deque<T> d, other;
+	std::deque<T> ref;
+	for (int i = 0; i < N; i++) {
+		d.push_back(T(i));
+		other.push_back(T(N + i));
+		ref.push_back(T(i));
+	}
+	T::copies = T::moves = 0;
+	// elements only move when split cuts through a block
+	sjtu::deque<T> rest = d.split_at(N / 2);
+	d.concat(rest);
+	rest = d.split_at(N / 4);
+	sjtu::deque<T> middle = d.split_at(N / 8);
+	d.concat(rest);
+	d.splice(d.begin() + N / 8, middle);
+	rest = tail_of(d, N / 2);
+	d.concat(rest);
+	d.concat(other);
+	sjtu::deque<T> moved(std::move(d));
+	d = std::move(moved);
+	long copies = T::copies, moves = T::moves;
+	for (int i = 0; i < N; i++) {
+		ref.push_back(T(N + i));
+	}
+	printf("copies: %ld\n", copies);
+	printf("moves: %s\n", moves < 2000 ? "few" : "too many");
+	printf("content: %s\n", equal(d, ref) ? "Accept" : "Wrong Answer");
+	printf("emptied: %s\n", rest.empty() && middle.empty() && other.empty() && moved.empty() ? "Accept" : "Wrong Answer");
+	// a moved-from deque is still usable
+	moved.push_back(T(1));
+	moved.push_front(T(0));
+	printf("reuse: %s\n", moved.size() == 2 && moved[0].x == 0 && moved[1].x == 1 ? "Accept" : "Wrong Answer");
+	return 0;
+}
@@ -0,0 +1,103 @@
+// deque: splice, concat and split_at checked against std::deque
+
+#include <iostream>
+#include <cstdio>
+#include <deque>
+#include <string>
+#include "../../deque.hpp"
+#include "../../exceptions.hpp"
+
+long long aa = 13131, bb = 5353, MOD = (long long) (1e9 + 7), now = 1;
+
+int rand () {
+	for (int i = 1; i < 3; i++)
+		now = (now * aa + bb) % MOD;
+	return now;
+}
+
+class T {
+public:
+	static int counter;
+	std::string s;
+	T (int x) : s(std::to_string(x)) { counter++; }
+	T (const T &other) : s(other.s) { counter++; }
+	T (T &&other) : s(std::move(other.s)) { counter++; }
+	T &operator= (const T &other) = default;
+	T &operator= (T &&other) = default;
+	~T () { counter--; }
+	bool operator!= (const T &other) const { return s != other.s; }
+};
+
+int T::counter = 0;
+
+template<class A, class B>
+bool equal (A &a, B &b) {
+	if (a.size() != b.size()) return false;
+	size_t i = 0;
+	for (auto it = a.begin(); it != a.end(); ++it, ++i) {
+		if (*it != b[i] || a[i] != b[i]) return false;
+	}
+	return true;
+}
+
+void test () {
+	const int K = 4;
+	sjtu::deque<T> q[K];
+	std::deque<T> ref[K];
+	bool ok = true;
+	for (int round = 0; round < 4000 && ok; round++) {
+		int x = rand() % K, y = rand() % K;
+		int op = rand() % 5;
+		if (op == 0) {
+			int k = rand() % 300;
+			for (int i = 0; i < k; i++) {
+				if (rand() & 1) q[x].push_back(T(i)), ref[x].push_back(T(i));
+				else q[x].push_front(T(i)), ref[x].push_front(T(i));
+			}
+		} else if (op == 1 && x != y) {
+			int pos = rand() % (ref[x].size() + 1);
+			auto it = q[x].splice(q[x].begin() + pos, q[y]);
+			// std::deque self-move-assigns an element when the inserted range is empty
+			if (!ref[y].empty()) ref[x].insert(ref[x].begin() + pos, ref[y].begin(), ref[y].end());
+			ref[y].clear();
+			if (it - q[x].begin() != pos) ok = false;
+		} else if (op == 2 && x != y) {
+			q[x].concat(q[y]);
+			if (!ref[y].empty()) ref[x].insert(ref[x].end(), ref[y].begin(), ref[y].end());
+			ref[y].clear();
+		} else if (op == 3) {
+			int pos = rand() % (ref[x].size() + 1);
+			if (x == y) continue;
+			q[y] = q[x].split_at(pos);
+			ref[y].assign(ref[x].begin() + pos, ref[x].end());
+			ref[x].erase(ref[x].begin() + pos, ref[x].end());
+		} else if (!ref[x].empty()) {
+			int k = rand() % 30;
+			for (int i = 0; i < k && !ref[x].empty(); i++) {
+				int pos = rand() % ref[x].size();
+				if (rand() & 1) {
+					q[x].erase(q[x].begin() + pos);
+					ref[x].erase(ref[x].begin() + pos);
+				} else {
+					q[x].insert(q[x].begin() + pos, T(-i));
+					ref[x].insert(ref[x].begin() + pos, T(-i));
+				}
+			}
+		}
+		for (int i = 0; i < K; i++) {
+			ok = ok && equal(q[i], ref[i]);
+		}
+	}
+	printf("splice & concat & split_at: %s\n", ok ? "Accept" : "Wrong Answer");
+	int thrown = 0;
+	try { q[0].splice(q[1].begin(), q[2]); } catch (sjtu::invalid_iterator) { thrown++; }
+	try { q[0].splice(q[0].begin(), q[0]); } catch (sjtu::runtime_error) { thrown++; }
+	try { q[0].split_at(q[0].size() + 1); } catch (sjtu::index_out_of_bound) { thrown++; }
+	printf("throw: %s\n", thrown == 3 ? "Accept" : "Wrong Answer");
+}
+
+int main () {
+	test();
+	printf("memory leak: %s\n", T::counter == 0 ? "no" : "yes");
+	return 0;
+}
@@ -0,0 +1,149 @@
+// ring_deque: random operations checked against std::deque
+
+#include <iostream>
+#include <cstdio>
+#include <deque>
+#include <string>
+#include "../../ring_deque.hpp"
+#include "../../exceptions.hpp"
+
+long long aa = 13131, bb = 5353, MOD = (long long) (1e9 + 7), now = 1;
+
+int rand () {
+	for (int i = 1; i < 3; i++)
+		now = (now * aa + bb) % MOD;
+	return now;
+}
+
+// no default constructor, and every live object is counted
+class T {
+public:
+	static int counter;
+	std::string s;
+	T (int x) : s(std::to_string(x)) { counter++; }
+	T (const T &other) : s(other.s) { counter++; }
+	T (T &&other) : s(std::move(other.s)) { counter++; }
+	T &operator= (const T &other) = default;
+	T &operator= (T &&other) = default;
+	~T () { counter--; }
+	bool operator!= (const T &other) const { return s != other.s; }
+};
+
+int T::counter = 0;
+
+template<class A, class B>
+bool equal (A &a, B &b) {
+	if (a.size() != b.size()) return false;
+	auto it = a.begin();
+	for (size_t i = 0; i < b.size(); i++, ++it) {
+		if (a[i] != b[i] || *it != b[i]) return false;
+	}
+	return it == a.end();
+}
+
+void test1 () {
+	printf("test1: push & pop at both ends        ");
+	sjtu::ring_deque<T> q;
+	std::deque<T> stl;
+	bool ok = true;
+	for (int i = 0; i < 300000; i++) {
+		int op = rand() % 10;
+		if (op < 3) q.push_back(T(i)), stl.push_back(T(i));
+		else if (op < 6) q.push_front(T(i)), stl.push_front(T(i));
+		else if (stl.empty()) continue;
+		else if (op < 8) q.pop_back(), stl.pop_back();
+		else q.pop_front(), stl.pop_front();
+		if (!stl.empty() && (q.front() != stl.front() || q.back() != stl.back())) ok = false;
+	}
+	ok = ok && equal(q, stl);
+	puts(ok ? "Accept" : "Wrong Answer");
+}
+
+void test2 () {
+	printf("test2: queue workload                 ");
+	sjtu::ring_deque<T> q;
+	bool ok = true;
+	int head = 0, tail = 0;
+	for (int round = 0; round < 200; round++) {
+		int push = rand() % 3000, pop = rand() % 3000;
+		for (int i = 0; i < push; i++) q.push_back(T(tail++));
+		for (int i = 0; i < pop && head < tail; i++, head++) {
+			if (q.front() != T(head)) ok = false;
+			q.pop_front();
+		}
+	}
+	ok = ok && q.size() == (size_t) (tail - head);
+	puts(ok ? "Accept" : "Wrong Answer");
+}
+
+void test3 () {
+	printf("test3: insert & erase                 ");
+	sjtu::ring_deque<T> q;
+	std::deque<T> stl;
+	bool ok = true;
+	for (int i = 0; i < 20000; i++) {
+		int op = rand() % 3;
+		if (op < 2 || stl.empty()) {
+			int pos = rand() % (stl.size() + 1);
+			auto it = q.insert(q.begin() + pos, T(i));
+			stl.insert(stl.begin() + pos, T(i));
+			if (it - q.begin() != pos || *it != T(i)) ok = false;
+		} else {
+			int pos = rand() % stl.size();
+			auto it = q.erase(q.begin() + pos);
+			stl.erase(stl.begin() + pos);
+			if (it - q.begin() != pos) ok = false;
+		}
+	}
+	// inserting an element of the deque itself
+	q.insert(q.begin() + q.size() / 3, q[q.size() / 2]);
+	stl.insert(stl.begin() + stl.size() / 3, stl[stl.size() / 2]);
+	ok = ok && equal(q, stl);
+	puts(ok ? "Accept" : "Wrong Answer");
+}
+
+void test4 () {
+	printf("test4: copy & assignment & clear      ");
+	sjtu::ring_deque<T> q;
+	std::deque<T> stl;
+	for (int i = 0; i < 5000; i++) {
+		q.push_front(T(i)), stl.push_front(T(i));
+		q.push_back(T(-i)), stl.push_back(T(-i));
+	}
+	sjtu::ring_deque<T> p(q);
+	bool ok = equal(p, stl);
+	p.clear();
+	ok = ok && p.empty();
+	p = q;
+	q.clear();
+	ok = ok && q.empty() && equal(p, stl);
+	p = p;
+	ok = ok && equal(p, stl);
+	puts(ok ? "Accept" : "Wrong Answer");
+}
+
+void test5 () {
+	printf("test5: throw                          ");
+	sjtu::ring_deque<T> q, p;
+	int thrown = 0;
+	try { q.pop_back(); } catch (sjtu::container_is_empty) { thrown++; }
+	try { q.front(); } catch (sjtu::container_is_empty) { thrown++; }
+	try { q.erase(q.begin()); } catch (sjtu::container_is_empty) { thrown++; }
+	q.push_back(T(1));
+	try { q.at(1); } catch (sjtu::index_out_of_bound) { thrown++; }
+	try { q.erase(q.end()); } catch (sjtu::invalid_iterator) { thrown++; }
+	try { q.insert(p.begin(), T(2)); } catch (sjtu::invalid_iterator) { thrown++; }
+	try { *q.end(); } catch (sjtu::invalid_iterator) { thrown++; }
+	try { q.end() - p.end(); } catch (sjtu::invalid_iterator) { thrown++; }
+	puts(thrown == 8 ? "Accept" : "Wrong Answer");
+}
+
+int main () {
+	test1();
+	test2();
+	test3();
+	test4();
+	test5();
+	printf("memory leak: %s\n", T::counter == 0 ? "no" : "yes");
+	return 0;
+}
@@ -0,0 +1,71 @@
+// spsc_queue: one producer and one consumer thread, order and leaks checked
+
+#include <iostream>
+#include <cstdio>
+#include <string>
+#include <thread>
+#include "../../spsc_queue.hpp"
+
+class T {
+public:
+	static std::atomic<int> counter;
+	std::string s;
+	T () { counter++; }
+	T (int x) : s(std::to_string(x)) { counter++; }
+	T (const T &other) : s(other.s) { counter++; }
+	T (T &&other) : s(std::move(other.s)) { counter++; }
+	T &operator= (const T &other) = default;
+	T &operator= (T &&other) = default;
+	~T () { counter--; }
+};
+
+std::atomic<int> T::counter(0);
+
+void test1 () {
+	printf("test1: single thread                  ");
+	sjtu::spsc_queue<T> q;
+	bool ok = q.empty();
+	int head = 0, tail = 0;
+	T result;
+	for (int round = 0; round < 100; round++) {
+		for (int i = 0; i < round * 37 % 1500; i++) q.push(T(tail++));
+		for (int i = 0; i < round * 53 % 1400; i++) {
+			if (q.pop(result)) {
+				if (result.s != std::to_string(head++)) ok = false;
+			} else if (head != tail) {
+				ok = false;
+			}
+		}
+	}
+	// the rest is destroyed by the queue
+	puts(ok && head < tail ? "Accept" : "Wrong Answer");
+}
+
+void test2 () {
+	printf("test2: producer and consumer threads  ");
+	const int N = 1000000;
+	bool ok = true;
+	{
+		sjtu::spsc_queue<T> q;
+		std::thread producer([&] {
+			for (int i = 0; i < N; i++) {
+				q.push(T(i));
+				if (i % 4096 == 0) std::this_thread::yield();
+			}
+		});
+		T result;
+		for (int i = 0; i < N - 100; i++) {
+			while (!q.pop(result)) std::this_thread::yield();
+			if (result.s != std::to_string(i)) ok = false;
+		}
+		producer.join();
+	}
+	puts(ok ? "Accept" : "Wrong Answer");
+}
+
+int main () {
+	test1();
+	test2();
+	printf("memory leak: %s\n", T::counter == 0 ? "no" : "yes");
+	return 0;
+}
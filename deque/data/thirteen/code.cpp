@@ -0,0 +1,31 @@
+// deque: element access and iteration must not allocate, checked with the allocation counter
+
+#include <cstdio>
+#include "../../deque.hpp"
+#include "../../exceptions.hpp"
+#include "../alloc-counter.hpp"
+
+int main () {
+	sjtu::deque<int> d;
+	for (int i = 0; i < 10000; i++) {
+		if (i % 2 == 0) {
+			d.push_back(i);
+		} else {
+			d.push_front(i);
+		}
+	}
+	const sjtu::deque<int> &c = d;
+	long long sum = 0;
+	EXPECT_NO_ALLOC("operator[]", for (int i = 0; i < 10000; i++) sum += d[i]);
+	EXPECT_NO_ALLOC("const at", for (int i = 0; i < 10000; i++) sum += c.at(i));
+	EXPECT_NO_ALLOC("front back", sum += c.front() + c.back());
+	EXPECT_NO_ALLOC("iterate", for (auto it = d.begin(); it != d.end(); ++it) sum += *it);
+	EXPECT_NO_ALLOC("const iterate", for (auto it = c.cbegin(); it != c.cend(); ++it) sum += *it);
+	EXPECT_NO_ALLOC("iterator arithmetic", for (int i = 0; i < 10000; i += 7) sum += *(d.begin() + i) + (d.end() - d.begin()));
+	EXPECT_NO_ALLOC("size", sum += d.size() + d.empty());
+	printf("%lld\n", sum);
+
+	// the counter itself: a copy allocates its blocks
+	printf("copy allocates: %d\n", (int) (alloc_counter::count([&] { sjtu::deque<int> copy(d); }) > 0));
+	return 0;
+}
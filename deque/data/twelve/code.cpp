@@ -0,0 +1,90 @@
+// deque: the count_stats policy, block splits and merges under middle inserts and erases
+
+#include <iostream>
+#include <cstdio>
+#include <type_traits>
+#include <utility>
+#include "../../deque.hpp"
+#include "../../exceptions.hpp"
+
+long long aa = 13131, bb = 5353, MOD = (long long) (1e9 + 7), now = 1;
+
+int rand () {
+	for (int i = 1; i < 3; i++)
+		now = (now * aa + bb) % MOD;
+	return now;
+}
+
+typedef sjtu::deque<int, sjtu::count_stats> counted;
+
+void print (const char *name, const counted &d) {
+	sjtu::container_stats s = d.stats();
+	printf("%s: size %d live %d splits %d merges %d maintains %d\n", name, (int) d.size(),
+	       (int) (s.allocations > s.deallocations && s.bytes_allocated > s.bytes_freed), (int) (s.splits > 0),
+	       (int) (s.merges > 0), (int) (s.maintains > 0));
+}
+
+// memory_usage() against the bytes the counting policy saw allocated
+template<class C>
+void footprint (const char *name, const C &c) {
+	sjtu::container_stats s = c.stats();
+	sjtu::container_memory m = c.memory_usage();
+	printf("%s memory: payload %d consistent %d\n", name, (int) m.payload,
+	       (int) (s.bytes_allocated - s.bytes_freed + sizeof(C) == m.total()));
+}
+
+// the default policy is an empty base: counting adds exactly the counters, no_stats adds nothing
+static_assert(std::is_empty<sjtu::no_stats>::value, "no_stats must be an empty base");
+static_assert(sizeof(sjtu::deque<int, sjtu::count_stats>) ==
+              sizeof(sjtu::deque<int>) + sizeof(sjtu::container_stats),
+              "the stats policy base must not add padding");
+
+int main () {
+	sjtu::deque<int> plain;
+	plain.push_back(1);
+	printf("%llu\n", plain.stats().allocations);
+
+	counted d;
+	for (int i = 0; i < 10000; i++) {
+		d.push_back(i);
+	}
+	print("push_back", d);
+	sjtu::container_stats s = d.stats();
+	printf("%llu %llu\n", s.splits, s.merges);
+	for (int i = 0; i < 10000; i++) {
+		d.insert(d.begin() + rand() % (d.size() + 1), i);
+	}
+	print("insert", d);
+	for (int i = 0; i < 15000; i++) {
+		d.erase(d.begin() + rand() % d.size());
+	}
+	print("erase", d);
+	counted copy(d);
+	sjtu::container_stats c = copy.stats();
+	printf("copy: %d %llu %llu\n", (int) (c.allocations > 0), c.splits, c.merges);
+	copy.clear();
+	c = copy.stats();
+	// only the two sentinels and the index are left
+	printf("clear: %llu\n", c.allocations - c.deallocations);
+	footprint("d", d);
+	footprint("clear", copy);
+
+	// blocks that change owner take their bytes along
+	counted big;
+	for (int i = 0; i < 5000; i++) {
+		big.push_back(i);
+	}
+	counted moved(std::move(big));
+	footprint("moved", moved);
+	footprint("moved from", big);
+	counted rest = moved.split_at(1000);
+	footprint("split head", moved);
+	footprint("split tail", rest);
+	moved.splice(moved.begin() + 500, rest);
+	footprint("spliced", moved);
+	footprint("spliced from", rest);
+	big = std::move(moved);
+	footprint("move assigned", big);
+	footprint("move assigned from", moved);
+	return 0;
+}
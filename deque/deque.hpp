@@ -1,73 +1,151 @@
 //a simple implementation of blocking list
+//every block keeps its elements in a contiguous ring buffer
 #ifndef SJTU_DEQUE_HPP
 #define SJTU_DEQUE_HPP
 
 #include "exceptions.hpp"
+#include "stats.hpp"
 
 #include <cstddef>
+#include <cstdlib>
 #include <cmath>
+#include <iterator>
+#include <memory>
+#include <new>
+#include <utility>
 
 namespace sjtu {
 
-    template<class T>
-    class deque {
+    /**
+     * Stats is the statistics policy, see stats.hpp; no_stats costs nothing.
+     */
+    template<class T , class Stats = no_stats>
+    class deque : private Stats {
     private:
 
-        struct node {
-            T data;
-            node *next;
-            node *prev;
-
-            node (const T &data , node *next = nullptr , node *prev = nullptr) : next(next) ,
-                                                                                                prev(prev) ,
-                                                                                                data(data) {}
-            node(){}
-            node (node *next  , node *prev ) : next(next) ,
-                                                                                prev(prev)  {}
-        };
-
+        // a fixed capacity ring buffer, element i lives in data[(start + i) % cap]
         struct block {
             block *next;
             block *prev;
-            node *head;
-            node *tail;
+            T *data;
+            int cap;
+            int start;
             int sz;
+            // position in the block index, head is -1 and tail is the number of blocks
+            int rank;
 
-            block (block *next = nullptr , block *prev = nullptr) : next(next) , prev(prev) {
-                head=(node*)malloc(sizeof(node));
-                head->prev= nullptr;
+            block (block *next = nullptr , block *prev = nullptr , int cap = 0) : next(next) , prev(prev) ,
+                                                                                cap(cap) , start(0) , sz(0) ,
+                                                                                rank(-1) {
+                data = cap == 0 ? nullptr : (T *) malloc(sizeof(T) * cap);
+            }
 
-                tail=(node*)malloc(sizeof(node));
-                tail->next= nullptr;
-                head->next = tail;
-                tail->prev = head;
-                sz=0;
+            block (const block &other) : next(nullptr) , prev(nullptr) , cap(other.cap) , start(0) , sz(0) ,
+                                         rank(-1) {
+                data = cap == 0 ? nullptr : (T *) malloc(sizeof(T) * cap);
+                // one or two contiguous pieces, memcpy when T is trivially copyable
+                int first = other.cap - other.start < other.sz ? other.cap - other.start : other.sz;
+                std::uninitialized_copy(other.data + other.start , other.data + other.start + first , data);
+                std::uninitialized_copy(other.data , other.data + (other.sz - first) , data + first);
+                sz = other.sz;
             }
 
-            block (const block &other) {
-                head=(node*)malloc(sizeof(node));
-                head->prev= nullptr;
-                auto p = head;
-                for (auto i = other.head->next; i != other.tail; i = i->next) {
-                    p->next = new node(i->data , nullptr , p);
-                    p = p->next;
+            ~block () {
+                for (int i = 0; i < sz; i++) {
+                    at(i).~T();
                 }
-                p->next =(node*)malloc(sizeof(node));
-                tail = p->next;
-                tail->next= nullptr;
-                tail->prev=p;
-                sz=other.sz;
+                free(data);
             }
 
-            ~block () {
-                auto p = head->next;
-                while (p != tail) {
-                    auto tmp = p;
-                    p = p->next;
-                    delete tmp;
+            int slot (int i) const {
+                i += start;
+                return i < cap ? i : i - cap;
+            }
+
+            T &at (int i) { return data[slot(i)]; }
+
+            const T &at (int i) const { return data[slot(i)]; }
+
+            bool full () const { return sz == cap; }
+
+            template<class V>
+            void push_back (V &&value) {
+                new(data + slot(sz)) T(std::forward<V>(value));
+                sz++;
+            }
+
+            template<class V>
+            void push_front (V &&value) {
+                int i = start == 0 ? cap - 1 : start - 1;
+                new(data + i) T(std::forward<V>(value));
+                start = i;
+                sz++;
+            }
+
+            // construct the next k elements of first in front of the block, in order
+            template<class ForwardIterator>
+            void push_front (ForwardIterator &first , int k) {
+                int i = start - k < 0 ? start - k + cap : start - k;
+                for (int j = 0; j < k; j++ , ++first) {
+                    new(data + (i + j < cap ? i + j : i + j - cap)) T(*first);
                 }
-                free(head);
-                free(tail);
+                start = i;
+                sz += k;
+            }
+
+            void pop_back () {
+                at(sz - 1).~T();
+                sz--;
+            }
+
+            void pop_front () {
+                at(0).~T();
+                start = slot(1);
+                sz--;
+            }
+
+            // move the element at from into the empty place to
+            void relocate (int to , int from) {
+                new(&at(to)) T(std::move(at(from)));
+                at(from).~T();
+            }
+
+            // the block must not be full, the shorter side is moved to make room
+            void insert (int i , const T &value) {
+                if (i == sz) {
+                    push_back(value);
+                    return;
+                }
+                // value may be one of the elements that move
+                T tmp(value);
+                if (i < sz / 2) {
+                    start = start == 0 ? cap - 1 : start - 1;
+                    sz++;
+                    for (int k = 0; k < i; k++) {
+                        relocate(k , k + 1);
+                    }
+                } else {
+                    sz++;
+                    for (int k = sz - 1; k > i; k--) {
+                        relocate(k , k - 1);
+                    }
+                }
+                new(&at(i)) T(std::move(tmp));
+            }
+
+            void erase (int i) {
+                at(i).~T();
+                if (i < sz / 2) {
+                    for (int k = i; k > 0; k--) {
+                        relocate(k , k - 1);
+                    }
+                    start = slot(1);
+                } else {
+                    for (int k = i; k < sz - 1; k++) {
+                        relocate(k , k + 1);
+                    }
+                }
+                sz--;
             }
         };
 
@@ -84,61 +162,41 @@ namespace sjtu {
         private:
             deque *thisdeque;
             block *outer;
-            node *inner;
+            // index inside outer, end() is (tail, 0)
+            int inner;
         public:
+            typedef std::random_access_iterator_tag iterator_category;
+            typedef T value_type;
+            typedef std::ptrdiff_t difference_type;
+            typedef T *pointer;
+            typedef T &reference;
 
-            iterator (deque *thisdeque = nullptr , block *outer = nullptr , node *inner = nullptr) : thisdeque
-                                                                                                                      (thisdeque) ,
-                                                                                                              outer(outer) ,
-                                                                                                              inner(inner) {}
+            iterator (deque *thisdeque = nullptr , block *outer = nullptr , int inner = 0) : thisdeque(thisdeque) ,
+                                                                                             outer(outer) ,
+                                                                                             inner(inner) {}
 
             /**
              * return a new iterator which pointer n-next elements
              *   even if there are not enough elements, the behaviour is **undefined**.
              * as well as operator-
              */
+            // the target block is found in the block index, then indexed directly
             iterator operator+ (const int &n) const {
-                if (n < 0) {
-                    return operator-(-n);
-                }
-                auto tmp = *this;
-                for (int i = 0; i < n; i++) {
-                    ++tmp;
-                }
-                return tmp;
+                return thisdeque->seek(thisdeque->index(outer , inner) + n);
             }
 
             iterator operator- (const int &n) const {
-                if (n < 0) {
-                    return operator+(-n);
-                }
-                auto tmp = *this;
-                for (int i = 0; i < n; i++) {
-                    --tmp;
-                }
-                return tmp;
+                return thisdeque->seek(thisdeque->index(outer , inner) - n);
             }
 
             // return th distance between two iterator,
             // if these two iterators points to different vectors, throw invaild_iterator.
 
-            int operator- ( iterator rhs) const {
+            int operator- (const iterator &rhs) const {
                 if (rhs.thisdeque != thisdeque) {
                     throw invalid_iterator();
                 }
-                int tmp1=thisdeque->order(outer);
-                int tmp2=rhs.thisdeque->order(rhs.outer);
-                if (tmp1 < tmp2 || (tmp1 == tmp2 && thisdeque->order(outer , inner) < thisdeque->order(rhs.outer , rhs
-                .inner)
-                )) {
-                    return -rhs.operator-(*this);
-                }
-                int result = 0;
-                while (rhs != *this) {
-                    rhs++;
-                    result++;
-                }
-                return result;
+                return thisdeque->index(outer , inner) - thisdeque->index(rhs.outer , rhs.inner);
             }
 
             iterator operator+= (const int &n) {
@@ -160,11 +218,9 @@ namespace sjtu {
 
 
             iterator &operator++ () {
-                if (inner->next == outer->tail) {
+                if (++inner == outer->sz) {
                     outer = outer->next;
-                    inner = outer->head->next;
-                } else {
-                    inner = inner->next;
+                    inner = 0;
                 }
                 return *this;
             }
@@ -178,21 +234,20 @@ namespace sjtu {
 
 
             iterator &operator-- () {
-
-                if (inner->prev == outer->head) {
+                if (inner == 0) {
                     outer = outer->prev;
-                    inner = outer->tail->prev;
-                } else {
-                    inner = inner->prev;
+                    inner = outer->sz;
                 }
+                inner--;
+                return *this;
             }
 
 
             T &operator* () const {
-                if (*this == thisdeque->end()||*this==(--thisdeque->begin())||this->inner== nullptr) {
+                if (outer == nullptr || inner < 0 || inner >= outer->sz) {
                     throw invalid_iterator();
                 }
-                return inner->data;
+                return outer->at(inner);
             }
 
             T *operator-> () const noexcept {
@@ -220,6 +275,26 @@ namespace sjtu {
             bool operator!= (const const_iterator &rhs) const {
                 return !operator==(rhs);
             }
+
+            bool operator< (const iterator &rhs) const {
+                return operator-(rhs) < 0;
+            }
+
+            bool operator> (const iterator &rhs) const {
+                return operator-(rhs) > 0;
+            }
+
+            bool operator<= (const iterator &rhs) const {
+                return operator-(rhs) <= 0;
+            }
+
+            bool operator>= (const iterator &rhs) const {
+                return operator-(rhs) >= 0;
+            }
+
+            T &operator[] (const int &n) const {
+                return *(*this + n);
+            }
         };
 
         class const_iterator : public iterator {
@@ -241,137 +316,313 @@ namespace sjtu {
 
     private:
 
+        // the blocks in order, with the position of their first element
+        struct slot {
+            block *outer;
+            long long first;
+        };
+
         block *head;
         block *tail;
         int totalsz = 0;
+        slot *slots = nullptr;
+        int nblocks = 0;
+        int slotcap = 0;
+        // position of the first element, so that push_front and pop_front only touch slots[0]
+        long long origin = 0;
+        // about sqrt(totalsz), only recomputed when totalsz leaves [low, high)
+        int limit = 4;
+        int low = 0;
+        int high = 16;
+
+        void retune () {
+            if (totalsz >= low && totalsz < high) {
+                return;
+            }
+            low = 16;
+            while (low * 2 <= totalsz) {
+                low *= 2;
+            }
+            high = low * 2;
+            limit = (int) sqrt(low);
+            if (totalsz < 16) {
+                low = 0;
+                high = 16;
+            }
+        }
+
+        // refresh the index from the block of rank from, whose predecessors must be up to date
+        void reindex (int from) {
+            block *p = from == 0 ? head->next : slots[from - 1].outer->next;
+            long long first = from == 0 ? origin : slots[from - 1].first + slots[from - 1].outer->sz;
+            int r = from;
+            for (; p != tail; p = p->next , r++) {
+                if (r == slotcap) {
+                    if (slotcap > 0) {
+                        Stats::on_deallocate(sizeof(slot) * slotcap);
+                        Stats::on_reallocate(r);
+                    }
+                    slotcap = slotcap == 0 ? 16 : slotcap * 2;
+                    Stats::on_allocate(sizeof(slot) * slotcap);
+                    slots = (slot *) realloc(slots , sizeof(slot) * slotcap);
+                }
+                slots[r].outer = p;
+                slots[r].first = first;
+                p->rank = r;
+                first += p->sz;
+            }
+            nblocks = r;
+            tail->rank = r;
+        }
 
-        block *find_outer_block (int p , int &used_size)const {
-            auto i = head->next;
-            for (; i != tail && p - i->sz >= 0; i = i->next) {
-                p -= i->sz;
-                used_size += i->sz;
+        // the elements behind block r moved by delta, the shorter end of the index is updated
+        void shift (int r , int delta) {
+            if (r >= nblocks / 2) {
+                for (int k = r + 1; k < nblocks; k++) {
+                    slots[k].first += delta;
+                }
+            } else {
+                origin -= delta;
+                for (int k = 0; k <= r; k++) {
+                    slots[k].first -= delta;
+                }
             }
-            return i;
         }
 
-        node *find_inner_block (block *outer , int p) const{
-            auto i = outer->head->next;
-            for (; i != outer->tail && p > 0; i = i->next) {
-                p--;
+        // binary search for the block holding pos, pos == totalsz gives end()
+        iterator seek (int pos) {
+            if (pos >= totalsz) {
+                return iterator(this , tail , pos - totalsz);
+            }
+            if (pos < 0) {
+                return iterator(this , head , pos);
+            }
+            long long target = origin + pos;
+            int l = 0 , r = nblocks - 1;
+            while (l < r) {
+                int mid = (l + r + 1) / 2;
+                if (slots[mid].first <= target) {
+                    l = mid;
+                } else {
+                    r = mid - 1;
+                }
             }
-            return i;
+            return iterator(this , slots[l].outer , (int) (target - slots[l].first));
         }
 
-        //[a,b]-->[a,c),[c,b]
-        void split (block *&outer , node *inner) {
-            if (inner == outer->head->next || inner == outer->tail) {
-                return;
+        // capacity of a block created now: room for a full sized block
+        int block_capacity (int least) const {
+            int cap = 2 * limit + 2;
+            if (cap < 8) {
+                cap = 8;
             }
-            auto i = order(outer , inner);
-            auto tmp = new block(outer->next , outer);
-            outer->next = tmp;
-            tmp->next->prev = tmp;
-            tmp->head->next = inner;
-            auto p=inner->prev;
-            inner->prev->next = outer->tail;
-            inner->prev = tmp->head;
-            outer->tail->prev->next = tmp->tail;
-            tmp->tail->prev = outer->tail->prev;
+            return cap < least ? least : cap;
+        }
 
-            outer->tail->prev =p;
-            tmp->sz = outer->sz - i;
-            outer->sz = i ;
-            outer = outer->next;
+        template<class... Args>
+        block *create (Args &&... args) {
+            auto p = new block(std::forward<Args>(args)...);
+            Stats::on_allocate(bytes(p));
+            return p;
+        }
+
+        void destroy (block *p) {
+            Stats::on_deallocate(bytes(p));
+            delete p;
+        }
 
+        // the heap bytes behind a block, as create counts them
+        static size_t bytes (const block *p) {
+            return sizeof(block) + sizeof(T) * p->cap;
+        }
+
+        // the blocks [first, last] change owner from giver to taker, so do their bytes in the counts
+        static void hand_over (deque &giver , deque &taker , block *first , block *last) {
+            size_t total = 0;
+            for (auto p = first; ; p = p->next) {
+                total += bytes(p);
+                if (p == last) {
+                    break;
+                }
+            }
+            giver.Stats::on_give(total);
+            taker.Stats::on_take(total);
+        }
+
+        // a new empty block between two neighbors
+        block *link (block *prev , block *next) {
+            auto tmp = create(next , prev , block_capacity(1));
+            prev->next = next->prev = tmp;
+            return tmp;
+        }
+
+        // unlink and free a block, its elements must have been moved out or destroyed
+        void remove (block *outer) {
+            outer->prev->next = outer->next;
+            outer->next->prev = outer->prev;
+            destroy(outer);
+        }
+
+        // move the first n elements of from to the back of to
+        static void move_front (block *from , block *to , int n) {
+            for (int i = 0; i < n; i++) {
+                to->push_back(std::move(from->at(0)));
+                from->pop_front();
+            }
+        }
+
+        // move the last n elements of from to the front of to
+        static void move_back (block *from , block *to , int n) {
+            for (int i = 0; i < n; i++) {
+                to->push_front(std::move(from->at(from->sz - 1)));
+                from->pop_back();
+            }
+        }
+
+        //[a,b]-->[a,c),[c,b], outer ends up at [c,b]
+        //the smaller side is moved to a new block
+        void split (block *&outer , int inner) {
+            if (inner == 0 || inner == outer->sz) {
+                return;
+            }
+            Stats::on_split();
+            if (inner <= outer->sz - inner) {
+                auto tmp = create(outer , outer->prev , block_capacity(inner));
+                tmp->prev->next = tmp;
+                outer->prev = tmp;
+                move_front(outer , tmp , inner);
+            } else {
+                auto tmp = create(outer->next , outer , block_capacity(outer->sz - inner));
+                tmp->next->prev = tmp;
+                outer->next = tmp;
+                move_back(outer , tmp , outer->sz - inner);
+                outer = tmp;
+            }
         }
 
         //[a,b][b+1,c]->[a,c]
         block *merge (block *outer1 , block *outer2) {
-
-            auto outer = new block(outer2->next , outer1->prev);
-            outer->sz = outer1->sz + outer2->sz;
+            Stats::on_merge();
+            int total = outer1->sz + outer2->sz;
+            if (outer1->cap >= total) {
+                move_front(outer2 , outer1 , outer2->sz);
+                remove(outer2);
+                return outer1;
+            }
+            if (outer2->cap >= total) {
+                move_back(outer1 , outer2 , outer1->sz);
+                remove(outer1);
+                return outer2;
+            }
+            auto outer = create(outer2->next , outer1->prev , block_capacity(total));
             outer->prev->next = outer;
             outer->next->prev = outer;
-            outer->head->next = outer1->head->next;
-            outer1->head->next->prev = outer->head;
-            outer1->tail->prev->next = outer2->head->next;
-            outer2->head->next->prev = outer1->tail->prev;
-            outer2->tail->prev->next = outer->tail;
-            outer->tail->prev = outer2->tail->prev;
-
-            free(outer1->head);
-            free(outer1->tail);
-            free(outer2->head);
-            free(outer2->tail);
-            free(outer1);
-            free(outer2);
+            move_front(outer1 , outer , outer1->sz);
+            move_front(outer2 , outer , outer2->sz);
+            destroy(outer1);
+            destroy(outer2);
             return outer;
         }
 
-        static int order (block *outer , node *inner) {
-            int cnt = 0;
-            for (auto i = outer->head->next; i != inner; i = i->next) {
-                cnt++;
+        // lay out the next n elements of first in evenly sized new blocks after prev, return the last one
+        template<class ForwardIterator>
+        block *fill (block *prev , ForwardIterator &first , int n) {
+            int per = 2 * limit;
+            int count = (n + per - 1) / per;
+            for (int i = 0; i < count; i++) {
+                int k = n / count + (i < n % count ? 1 : 0);
+                prev = link(prev , prev->next);
+                for (int j = 0; j < k; j++ , ++first) {
+                    prev->push_back(*first);
+                }
             }
-            return cnt;
+            return prev;
         }
 
-        void split_half (block *outer) {
-            auto i=outer->sz/2;
-            auto inner=find_inner_block(outer,i);
-            split(outer,inner);
+        // merge p with its neighbors while the result stays within the bound, return whether anything changed
+        bool maintain (block *p) {
+            Stats::on_maintain();
+            bool changed = false;
+            if (p->prev != head && p->prev->sz + p->sz <= limit) {
+                p = merge(p->prev , p);
+                changed = true;
+            }
+            if (p->next != tail && p->sz + p->next->sz <= limit) {
+                merge(p , p->next);
+                changed = true;
+            }
+            return changed;
         }
-        block* maintain (block *p= nullptr) {
 
-            for (auto i = head->next; i != tail->prev&&i!=tail; i = i->next) {
-                if (i->sz + i->next->sz <= sqrt(totalsz)) {
-                    if (i == p || i->next == p) {
-                        p=i=merge(i,i->next);
-                    } else {
-                        i=merge(i,i->next);
-                    }
-                }
+        // number of elements in front of (outer, inner)
+        int index (block *outer , int inner) const {
+            if (outer == head) {
+                return inner;
             }
-            return p;
+            if (outer == tail) {
+                return totalsz + inner;
+            }
+            return (int) (slots[outer->rank].first - origin) + inner;
         }
 
-        int order (block *outer){
-            int cnt = 0;
-            for (auto i = head->next; i != outer; i = i->next) {
-                cnt++;
+        T &locate (const size_t &pos) const {
+            if (pos >= (size_t) totalsz) {
+                throw index_out_of_bound();
             }
-            return cnt;
+            auto it = const_cast<deque *>(this)->seek(pos);
+            return it.outer->at(it.inner);
         }
 
     public:
         deque () {
-            head = new block;
-            head->next = tail = new block;
+            head = create();
+            head->next = tail = create();
             tail->prev = head;
+            reindex(0);
         }
 
         deque (const deque &other) {
-            head = new block;
+            head = create();
             auto p = head;
             for (auto i = other.head->next; i != other.tail; i = i->next) {
-                p->next = new block(*i);
+                p->next = create(*i);
                 p->next->prev = p;
                 p = p->next;
             }
-            p->next = new block(nullptr , p);
+            p->next = create(nullptr , p);
             tail = p->next;
             tail->prev=p;
             totalsz=other.totalsz;
+            retune();
+            reindex(0);
+        }
+
+        /**
+         * takes the blocks and the index of other, other is left empty
+         */
+        deque (deque &&other) : deque() {
+            steal(other);
         }
 
+        /**
+         * construct from the forward range [first, last)
+         */
+        template<class ForwardIterator>
+        deque (ForwardIterator first , ForwardIterator last) : deque() {
+            append(first , last);
+        }
 
         ~deque () {
             auto p = head;
             while (p != nullptr) {
                 auto tmp = p;
                 p = p->next;
-                delete tmp;
+                destroy(tmp);
+            }
+            if (slots != nullptr) {
+                Stats::on_deallocate(sizeof(slot) * slotcap);
             }
+            free(slots);
         }
 
 
@@ -383,7 +634,7 @@ namespace sjtu {
             auto tmp = head;
             auto p = other.head->next;
             while (p != other.tail) {
-                tmp->next = new block(*p);
+                tmp->next = create(*p);
                 tmp->next->prev = tmp;
                 tmp = tmp->next;
                 p = p->next;
@@ -391,31 +642,39 @@ namespace sjtu {
             tmp->next = tail;
             tail->prev = tmp;
             totalsz=other.totalsz;
+            retune();
+            reindex(0);
+            return *this;
+        }
+
+        deque &operator= (deque &&other) {
+            if (&other == this) {
+                return *this;
+            }
+            clear();
+            steal(other);
             return *this;
         }
 
+        /**
+         * replace the contents with the forward range [first, last)
+         */
+        template<class ForwardIterator>
+        void assign (ForwardIterator first , ForwardIterator last) {
+            clear();
+            append(first , last);
+        }
+
         /**
          * access specified element with bounds checking
          * throw index_out_of_bound if out of bound.
          */
         T &at (const size_t &pos) {
-            if (pos >= totalsz || pos < 0) {
-                throw index_out_of_bound();
-            }
-            int left = 0;
-            auto outer = find_outer_block(pos , left);
-            auto inner = find_inner_block(outer , pos-left);
-            return inner->data;
+            return locate(pos);
         }
 
         const T &at (const size_t &pos) const {
-            if (pos >= totalsz || pos < 0) {
-                throw index_out_of_bound();
-            }
-            int left = 0;
-            auto outer = find_outer_block(const_cast<size_t& >(pos) , left);
-            auto inner = find_inner_block(outer , const_cast<size_t& >(pos)-left);
-            return inner->data;
+            return locate(pos);
         }
 
         T &operator[] (const size_t &pos) {
@@ -434,7 +693,7 @@ namespace sjtu {
             if (totalsz == 0) {
                 throw container_is_empty();
             }
-            return head->next->head->next->data;
+            return head->next->at(0);
         }
 
         /**
@@ -445,14 +704,14 @@ namespace sjtu {
             if (totalsz == 0) {
                 throw container_is_empty();
             }
-            return tail->prev->tail->prev->data;
+            return tail->prev->at(tail->prev->sz - 1);
         }
 
         /**
          * returns an iterator to the beginning.
          */
         iterator begin () {
-            return iterator(this , head->next , head->next->head->next);
+            return iterator(this , head->next , 0);
         }
 
         const_iterator cbegin () const {
@@ -463,7 +722,7 @@ namespace sjtu {
          * returns an iterator to the end.
          */
         iterator end () {
-            return iterator(this , tail , tail->tail);
+            return iterator(this , tail , 0);
         }
 
         const_iterator cend () const { return const_cast<deque*>(this)->end(); }
@@ -478,6 +737,52 @@ namespace sjtu {
          */
         size_t size () const { return totalsz; }
 
+        /**
+         * what this deque has done so far, all zero unless Stats counts.
+         */
+        container_stats stats () const { return Stats::snapshot(); }
+
+        /**
+         * bytes held, the block headers (sentinels included), their unused room and the index count as overhead.
+         */
+        container_memory memory_usage () const {
+            container_memory m;
+            m.payload = sizeof(T) * totalsz;
+            m.overhead = sizeof(deque) + sizeof(slot) * slotcap;
+            for (auto p = head; p != nullptr; p = p->next) {
+                m.overhead += sizeof(block) + sizeof(T) * (p->cap - p->sz);
+            }
+            return m;
+        }
+
+    private:
+        // forget the blocks after they have been moved to another deque
+        void release () {
+            head->next = tail;
+            tail->prev = head;
+            totalsz = 0;
+            origin = 0;
+            retune();
+            reindex(0);
+        }
+
+        // swap blocks and index with other, iterators of both deques are invalidated
+        void steal (deque &other) {
+            std::swap(head , other.head);
+            std::swap(tail , other.tail);
+            std::swap(totalsz , other.totalsz);
+            std::swap(slots , other.slots);
+            std::swap(nblocks , other.nblocks);
+            std::swap(slotcap , other.slotcap);
+            std::swap(origin , other.origin);
+            std::swap(limit , other.limit);
+            std::swap(low , other.low);
+            std::swap(high , other.high);
+            // the counts go with the blocks and the index they describe
+            std::swap(static_cast<Stats &>(*this) , static_cast<Stats &>(other));
+        }
+
+    public:
         /**
          * clears the contents
          */
@@ -487,10 +792,13 @@ namespace sjtu {
             while (p != tail) {
                 auto tmp = p;
                 p = p->next;
-                delete tmp;
+                destroy(tmp);
             }
             head->next = tail;
             tail->prev = head;
+            origin = 0;
+            retune();
+            reindex(0);
         }
 
         /**
@@ -500,21 +808,161 @@ namespace sjtu {
          *     throw if the iterator is invalid or it point to a wrong place.
          */
         iterator insert (iterator pos , const T &value) {
-            if (pos.thisdeque != this || pos.inner == nullptr || pos.outer == nullptr) {
+            if (pos.thisdeque != this || pos.outer == nullptr || pos.outer == head || pos.inner < 0 ||
+                pos.inner > pos.outer->sz || (pos.outer == tail && pos.inner != 0)) {
                 throw invalid_iterator();
             }
+            // splitting moves elements between blocks, but never changes their rank
+            int rank = index(pos.outer , pos.inner);
             totalsz++;
-            split(pos.outer , pos.inner);
-            auto tmp = new block(pos.outer , pos.outer->prev);
-            tmp->sz = 1;
-            node *result2 = tmp->head->next = new node(value , tmp->tail , tmp->head);
-            result2->next->prev = result2;
-            tmp->next->prev = tmp;
-            tmp->prev->next = tmp;
-            block *result=maintain(tmp);
-            return iterator(this , result , result2);
+            retune();
+            auto outer = pos.outer;
+            int inner = pos.inner;
+            if (outer == tail) {
+                outer = tail->prev;
+                inner = outer->sz;
+            }
+            if (outer == head) {
+                link(head , tail)->push_back(value);
+                reindex(0);
+                return begin();
+            }
+            int r = outer->rank;
+            if (outer->full()) {
+                // both halves have room afterwards
+                int half = outer->sz / 2;
+                split(outer , half);
+                if (inner < half) {
+                    outer = outer->prev;
+                } else {
+                    inner -= half;
+                }
+                outer->insert(inner , value);
+                reindex(r);
+            } else {
+                outer->insert(inner , value);
+                if (outer->sz > 2 * limit) {
+                    split(outer , outer->sz / 2);
+                    reindex(r);
+                } else {
+                    shift(r , 1);
+                }
+            }
+            return seek(rank);
+        }
 
+        /**
+         * inserts the forward range [first, last) before pos
+         * returns an iterator pointing to the first inserted value, or pos if the range is empty
+         *     throw if the iterator is invalid or it point to a wrong place.
+         */
+        template<class ForwardIterator>
+        iterator insert (iterator pos , ForwardIterator first , ForwardIterator last) {
+            if (pos.thisdeque != this || pos.outer == nullptr || pos.outer == head || pos.inner < 0 ||
+                pos.inner > pos.outer->sz || (pos.outer == tail && pos.inner != 0)) {
+                throw invalid_iterator();
+            }
+            int rank = index(pos.outer , pos.inner);
+            if (rank == totalsz) {
+                append(first , last);
+                return seek(rank);
+            }
+            int n = (int) std::distance(first , last);
+            if (n == 0) {
+                return seek(rank);
+            }
+            totalsz += n;
+            retune();
+            auto outer = pos.outer;
+            int r = outer->rank;
+            split(outer , pos.inner);
+            auto p = fill(outer->prev , first , n);
+            if (n <= limit) {
+                // a short range lands in one small block, give it a chance to join its neighbors
+                maintain(p);
+            }
+            reindex(r > 0 ? r - 1 : 0);
+            return seek(rank);
+        }
 
+        /**
+         * moves all elements of other before pos by relinking its blocks, other becomes empty.
+         * returns an iterator pointing to the first moved element, or pos if other is empty.
+         *     throw if the iterator is invalid, or other is this deque.
+         */
+        iterator splice (iterator pos , deque &other) {
+            if (pos.thisdeque != this || pos.outer == nullptr || pos.outer == head || pos.inner < 0 ||
+                pos.inner > pos.outer->sz || (pos.outer == tail && pos.inner != 0)) {
+                throw invalid_iterator();
+            }
+            if (&other == this) {
+                throw runtime_error();
+            }
+            int rank = index(pos.outer , pos.inner);
+            if (other.totalsz == 0) {
+                return seek(rank);
+            }
+            auto after = pos.outer;
+            int r = after->rank;
+            split(after , pos.inner);
+            auto first = other.head->next;
+            auto last = other.tail->prev;
+            hand_over(other , *this , first , last);
+            first->prev = after->prev;
+            last->next = after;
+            after->prev->next = first;
+            after->prev = last;
+            totalsz += other.totalsz;
+            retune();
+            other.release();
+            // only the seams can hold small blocks
+            if (first->prev != head && first->prev->sz + first->sz <= limit) {
+                merge(first->prev , first);
+            }
+            if (after != tail && after->prev->sz + after->sz <= limit) {
+                merge(after->prev , after);
+            }
+            reindex(r > 0 ? r - 1 : 0);
+            return seek(rank);
+        }
+
+        /**
+         * moves all elements of other to the end, other becomes empty.
+         */
+        void concat (deque &other) {
+            splice(end() , other);
+        }
+
+        /**
+         * cuts the deque before pos, the elements from pos on are moved to the returned deque.
+         *     throw index_out_of_bound if pos > size().
+         */
+        deque split_at (const size_t &pos) {
+            if (pos > (size_t) totalsz) {
+                throw index_out_of_bound();
+            }
+            deque rest;
+            auto it = seek(pos);
+            if (it.outer == tail) {
+                return rest;
+            }
+            auto first = it.outer;
+            split(first , it.inner);
+            auto last = tail->prev;
+            hand_over(*this , rest , first , last);
+            first->prev->next = tail;
+            tail->prev = first->prev;
+            rest.head->next = first;
+            first->prev = rest.head;
+            rest.tail->prev = last;
+            last->next = rest.tail;
+            rest.totalsz = totalsz - pos;
+            totalsz = pos;
+            rest.retune();
+            rest.reindex(0);
+            retune();
+            reindex(it.outer->rank > 0 ? it.outer->rank - 1 : 0);
+            return rest;
         }
 
         /**
@@ -524,26 +972,31 @@ namespace sjtu {
          * throw if the container is empty, the iterator is invalid or it points to a wrong place.
          */
         iterator erase (iterator pos) {
-            if (pos.thisdeque != this || pos.inner == nullptr || pos.outer == nullptr) {
+            if (pos.thisdeque != this) {
                 throw invalid_iterator();
             }
             if (totalsz == 0) {
                 throw container_is_empty();
             }
+            if (pos.outer == nullptr || pos.outer == head || pos.outer == tail || pos.inner < 0 ||
+                pos.inner >= pos.outer->sz) {
+                throw invalid_iterator();
+            }
+            int rank = index(pos.outer , pos.inner);
+            int r = pos.outer->rank;
             totalsz--;
-            split(pos.outer , pos.inner);
-            auto tmp = pos.outer;
-            split(tmp , pos.inner->next);
-            pos.outer->next->prev = pos.outer->prev;
-            pos.outer->prev->next = pos.outer->next;
-            tmp = pos.outer->next;
-            auto result2 = tmp->head->next;
-            delete pos.outer;
-            block* result1=tmp;
-            if(tmp!=tail && tmp->prev!=head) {
-                result1 = merge(tmp->prev , tmp);
+            retune();
+            auto outer = pos.outer;
+            outer->erase(pos.inner);
+            if (outer->sz == 0) {
+                remove(outer);
+                reindex(r > 0 ? r - 1 : 0);
+            } else if (maintain(outer)) {
+                reindex(r > 0 ? r - 1 : 0);
+            } else {
+                shift(r , -1);
             }
-            return iterator(this , result1 , result2);
+            return seek(rank);
         }
 
         /**
@@ -551,21 +1004,13 @@ namespace sjtu {
          */
         void push_back (const T &value) {
             totalsz++;
-            if (totalsz == 1) {
-                head->next=new block(tail,head);
-                head->next->head->next=new node(value,head->next->tail,head->next->head);
-                head->next->sz=1;
-                head->next->tail->prev=head->next->head->next;
-                tail->prev=head->next;
-                return;
-            }
-            tail->prev->tail->prev=new node(value,tail->prev->tail,tail->prev->tail->prev);
-            tail->prev->tail->prev->prev->next=tail->prev->tail->prev;
-            tail->prev->sz++;
-            if (tail->prev->sz >= 2 * sqrt(totalsz)) {
-                split_half(tail->prev);
-                maintain();
+            retune();
+            // a block at the end is closed once it is full, nothing is moved
+            if (tail->prev == head || tail->prev->full() || tail->prev->sz >= 2 * limit) {
+                link(tail->prev , tail);
+                reindex(nblocks);
             }
+            tail->prev->push_back(value);
         }
 
         /**
@@ -577,17 +1022,11 @@ namespace sjtu {
                 throw container_is_empty();
             }
             totalsz--;
-            if (tail->prev->sz == 1) {
-                auto tmp=tail->prev;
-                tail->prev->prev->next=tail;
-                tail->prev=tail->prev->prev;
-                delete tmp;
-            } else {
-                tail->prev->sz--;
-                auto tmp=tail->prev->tail->prev;
-                tmp->next->prev=tmp->prev;
-                tmp->prev->next=tmp->next;
-                delete tmp;
+            retune();
+            tail->prev->pop_back();
+            if (tail->prev->sz == 0) {
+                remove(tail->prev);
+                reindex(nblocks - 1);
             }
         }
 
@@ -596,21 +1035,74 @@ namespace sjtu {
          */
         void push_front (const T &value) {
             totalsz++;
-            if (totalsz == 1) {
-                head->next=new block(tail,head);
-                head->next->head->next=new node(value,head->next->tail,head->next->head);
-                head->next->sz=1;
-                head->next->tail->prev=head->next->head->next;
-                tail->prev=head->next;
+            retune();
+            origin--;
+            if (head->next == tail || head->next->full() || head->next->sz >= 2 * limit) {
+                link(head , head->next)->push_front(value);
+                reindex(0);
+            } else {
+                head->next->push_front(value);
+                slots[0].first = origin;
+            }
+        }
+
+        /**
+         * adds the forward range [first, last) to the end, laid out in full blocks
+         */
+        template<class ForwardIterator>
+        void append (ForwardIterator first , ForwardIterator last) {
+            int n = (int) std::distance(first , last);
+            if (n == 0) {
                 return;
             }
-            head->next->head->next=new node(value,head->next->head->next,head->next->head);
-            head->next->head->next->next->prev=head->next->head->next;
-            head->next->sz++;
-            if (head->next->sz >= 2 * sqrt(totalsz)) {
-                split_half(head->next);
-                maintain();
+            totalsz += n;
+            retune();
+            int r = nblocks > 0 ? nblocks - 1 : 0;
+            auto p = tail->prev;
+            if (p != head) {
+                // top up the last block first
+                for (; n > 0 && !p->full() && p->sz < 2 * limit; n-- , ++first) {
+                    p->push_back(*first);
+                }
+            }
+            if (n > 0) {
+                fill(p , first , n);
+            }
+            reindex(r);
+        }
+
+        /**
+         * adds the forward range [first, last) to the beginning, keeping its order
+         */
+        template<class ForwardIterator>
+        void prepend (ForwardIterator first , ForwardIterator last) {
+            int n = (int) std::distance(first , last);
+            if (n == 0) {
+                return;
+            }
+            totalsz += n;
+            retune();
+            origin -= n;
+            auto p = head->next;
+            // the last elements of the range top up the first block, as append does with the last one
+            int k = 0;
+            if (p != tail) {
+                k = (p->cap < 2 * limit ? p->cap : 2 * limit) - p->sz;
+                k = k < 0 ? 0 : k > n ? n : k;
+            }
+            if (k > 0) {
+                auto mid = first;
+                std::advance(mid , n - k);
+                p->push_front(mid , k);
+            }
+            if (n > k) {
+                auto q = fill(head , first , n - k);
+                if (n - k <= limit) {
+                    // a short range lands in one small block, give it a chance to join its neighbor
+                    maintain(q);
+                }
             }
+            reindex(0);
         }
 
         /**
@@ -622,17 +1114,14 @@ namespace sjtu {
                 throw container_is_empty();
             }
             totalsz--;
-            if (head->next->sz == 1) {
-                auto tmp=head->next;
-                tmp->next->prev=tmp->prev;
-                tmp->prev->next=tmp->next;
-                delete tmp;
+            retune();
+            origin++;
+            head->next->pop_front();
+            if (head->next->sz == 0) {
+                remove(head->next);
+                reindex(0);
             } else {
-                head->next->sz--;
-                auto tmp=head->next->head->next;
-                tmp->next->prev=tmp->prev;
-                tmp->prev->next=tmp->next;
-                delete tmp;
+                slots[0].first = origin;
             }
         }
 
@@ -641,4 +1130,4 @@ namespace sjtu {
 
 }
 
-#endif
\ No newline at end of file
+#endif
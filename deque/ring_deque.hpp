@@ -0,0 +1,460 @@
+//a deque made of fixed size chunks and a central map of chunk pointers, as in libstdc++
+//push and pop at both ends are amortized O(1) and so is random access,
+//inserting or erasing in the middle moves the elements of the shorter side
+#ifndef SJTU_RING_DEQUE_HPP
+#define SJTU_RING_DEQUE_HPP
+
+#include "exceptions.hpp"
+
+#include <cstddef>
+#include <cstdlib>
+#include <iterator>
+#include <new>
+#include <utility>
+
+namespace sjtu {
+
+    template<class T>
+    class ring_deque {
+    private:
+        // about 1KB to 4KB per chunk, never less than 16 elements
+        static const size_t SHIFT = sizeof(T) >= 64 ? 4 : sizeof(T) >= 16 ? 6 : 8;
+        static const size_t CHUNK = (size_t) 1 << SHIFT;
+        static const size_t MASK = CHUNK - 1;
+        static const size_t MIN_MAP = 8;
+
+        // chunk i holds the positions [i * CHUNK, (i + 1) * CHUNK), only chunks with elements are allocated
+        T **map;
+        size_t mapcap;
+        // position of the first element
+        size_t head;
+        size_t length = 0;
+        // the last released chunk, kept so that a queue does not malloc and free at every chunk boundary
+        T *spare = nullptr;
+
+    public:
+        class const_iterator;
+
+        class iterator {
+            friend class ring_deque;
+
+        private:
+            ring_deque *thisdeque;
+            size_t index;
+
+        public:
+            typedef std::random_access_iterator_tag iterator_category;
+            typedef T value_type;
+            typedef std::ptrdiff_t difference_type;
+            typedef T *pointer;
+            typedef T &reference;
+
+            iterator (ring_deque *thisdeque = nullptr , size_t index = 0) : thisdeque(thisdeque) , index(index) {}
+
+            iterator operator+ (const int &n) const {
+                return iterator(thisdeque , index + n);
+            }
+
+            iterator operator- (const int &n) const {
+                return iterator(thisdeque , index - n);
+            }
+
+            // if these two iterators points to different deques, throw invalid_iterator.
+            int operator- (const iterator &rhs) const {
+                if (rhs.thisdeque != thisdeque) {
+                    throw invalid_iterator();
+                }
+                return (int) (index - rhs.index);
+            }
+
+            iterator operator+= (const int &n) {
+                index += n;
+                return *this;
+            }
+
+            iterator operator-= (const int &n) {
+                index -= n;
+                return *this;
+            }
+
+            iterator operator++ (int) {
+                auto tmp = *this;
+                index++;
+                return tmp;
+            }
+
+            iterator &operator++ () {
+                index++;
+                return *this;
+            }
+
+            iterator operator-- (int) {
+                auto tmp = *this;
+                index--;
+                return tmp;
+            }
+
+            iterator &operator-- () {
+                index--;
+                return *this;
+            }
+
+            T &operator* () const {
+                if (thisdeque == nullptr || index >= thisdeque->length) {
+                    throw invalid_iterator();
+                }
+                return thisdeque->element(index);
+            }
+
+            T *operator-> () const {
+                return &(*(*this));
+            }
+
+            bool operator== (const iterator &rhs) const {
+                return index == rhs.index && thisdeque == rhs.thisdeque;
+            }
+
+            bool operator== (const const_iterator &rhs) const {
+                return index == rhs.index && thisdeque == rhs.thisdeque;
+            }
+
+            bool operator!= (const iterator &rhs) const {
+                return !operator==(rhs);
+            }
+
+            bool operator!= (const const_iterator &rhs) const {
+                return !operator==(rhs);
+            }
+
+            bool operator< (const iterator &rhs) const {
+                return operator-(rhs) < 0;
+            }
+
+            bool operator> (const iterator &rhs) const {
+                return operator-(rhs) > 0;
+            }
+
+            bool operator<= (const iterator &rhs) const {
+                return operator-(rhs) <= 0;
+            }
+
+            bool operator>= (const iterator &rhs) const {
+                return operator-(rhs) >= 0;
+            }
+
+            T &operator[] (const int &n) const {
+                return *(*this + n);
+            }
+        };
+
+        class const_iterator : public iterator {
+        public:
+            const_iterator () : iterator() {}
+
+            const_iterator (const const_iterator &other) : iterator(other) {}
+
+            const_iterator (const iterator &other) : iterator(other) {}
+        };
+
+    private:
+        T &element (size_t i) const {
+            size_t p = head + i;
+            return map[p >> SHIFT][p & MASK];
+        }
+
+        void acquire (size_t chunk) {
+            if (map[chunk] == nullptr) {
+                if (spare != nullptr) {
+                    map[chunk] = spare;
+                    spare = nullptr;
+                } else {
+                    map[chunk] = (T *) malloc(sizeof(T) * CHUNK);
+                }
+            }
+        }
+
+        void release (size_t chunk) {
+            if (spare == nullptr) {
+                spare = map[chunk];
+            } else {
+                free(map[chunk]);
+            }
+            map[chunk] = nullptr;
+        }
+
+        // move the chunks in use to the middle of a map, growing it if it is more than half full
+        void remap () {
+            size_t first = head >> SHIFT;
+            size_t used = length == 0 ? 0 : ((head + length - 1) >> SHIFT) - first + 1;
+            size_t capa = used * 2 + 2 <= mapcap ? mapcap : mapcap * 2;
+            auto tmp = (T **) calloc(capa , sizeof(T *));
+            size_t newfirst = (capa - used) / 2;
+            for (size_t i = 0; i < used; i++) {
+                tmp[newfirst + i] = map[first + i];
+            }
+            free(map);
+            map = tmp;
+            mapcap = capa;
+            head = (newfirst << SHIFT) + (head & MASK);
+        }
+
+        // move the element at from into the empty place to
+        void relocate (size_t to , size_t from) {
+            new(&element(to)) T(std::move(element(from)));
+            element(from).~T();
+        }
+
+        // forget the last element, which has been destroyed or moved out
+        void drop_back () {
+            size_t p = head + length - 1;
+            length--;
+            if (length == 0 || (p & MASK) == 0) {
+                release(p >> SHIFT);
+            }
+        }
+
+        // forget the first element, which has been destroyed or moved out
+        void drop_front () {
+            size_t p = head;
+            head++;
+            length--;
+            if (length == 0 || (head & MASK) == 0) {
+                release(p >> SHIFT);
+            }
+        }
+
+        void init () {
+            mapcap = MIN_MAP;
+            map = (T **) calloc(mapcap , sizeof(T *));
+            head = (mapcap / 2) << SHIFT;
+        }
+
+        template<class V>
+        void emplace_back (V &&value) {
+            if (((head + length) >> SHIFT) == mapcap) {
+                remap();
+            }
+            size_t p = head + length;
+            acquire(p >> SHIFT);
+            new(map[p >> SHIFT] + (p & MASK)) T(std::forward<V>(value));
+            length++;
+        }
+
+        template<class V>
+        void emplace_front (V &&value) {
+            if (head == 0) {
+                remap();
+            }
+            size_t p = head - 1;
+            acquire(p >> SHIFT);
+            new(map[p >> SHIFT] + (p & MASK)) T(std::forward<V>(value));
+            head = p;
+            length++;
+        }
+
+    public:
+        ring_deque () {
+            init();
+        }
+
+        ring_deque (const ring_deque &other) {
+            init();
+            for (size_t i = 0; i < other.length; i++) {
+                emplace_back(other.element(i));
+            }
+        }
+
+        ~ring_deque () {
+            clear();
+            free(spare);
+            free(map);
+        }
+
+        ring_deque &operator= (const ring_deque &other) {
+            if (&other == this) {
+                return *this;
+            }
+            clear();
+            for (size_t i = 0; i < other.length; i++) {
+                emplace_back(other.element(i));
+            }
+            return *this;
+        }
+
+        /**
+         * access specified element with bounds checking
+         * throw index_out_of_bound if out of bound.
+         */
+        T &at (const size_t &pos) {
+            if (pos >= length) {
+                throw index_out_of_bound();
+            }
+            return element(pos);
+        }
+
+        const T &at (const size_t &pos) const {
+            if (pos >= length) {
+                throw index_out_of_bound();
+            }
+            return element(pos);
+        }
+
+        T &operator[] (const size_t &pos) {
+            return at(pos);
+        }
+
+        const T &operator[] (const size_t &pos) const {
+            return at(pos);
+        }
+
+        /**
+         * access the first element
+         * throw container_is_empty when the container is empty.
+         */
+        const T &front () const {
+            if (length == 0) {
+                throw container_is_empty();
+            }
+            return element(0);
+        }
+
+        /**
+         * access the last element
+         * throw container_is_empty when the container is empty.
+         */
+        const T &back () const {
+            if (length == 0) {
+                throw container_is_empty();
+            }
+            return element(length - 1);
+        }
+
+        iterator begin () {
+            return iterator(this , 0);
+        }
+
+        const_iterator cbegin () const {
+            return const_cast<ring_deque *>(this)->begin();
+        }
+
+        iterator end () {
+            return iterator(this , length);
+        }
+
+        const_iterator cend () const {
+            return const_cast<ring_deque *>(this)->end();
+        }
+
+        bool empty () const { return length == 0; }
+
+        size_t size () const { return length; }
+
+        void clear () {
+            while (length > 0) {
+                pop_back();
+            }
+        }
+
+        /**
+         * inserts value before pos, returns an iterator pointing to the inserted value
+         *     throw if the iterator is invalid or it point to a wrong place.
+         */
+        iterator insert (iterator pos , const T &value) {
+            if (pos.thisdeque != this || pos.index > length) {
+                throw invalid_iterator();
+            }
+            size_t idx = pos.index;
+            if (idx == 0) {
+                emplace_front(value);
+                return begin();
+            }
+            if (idx == length) {
+                emplace_back(value);
+                return iterator(this , idx);
+            }
+            // value may refer to an element that is about to move
+            T tmp(value);
+            // the shorter side is relocated one place outwards, T need not be assignable
+            if (idx < length / 2) {
+                emplace_front(std::move(element(0)));
+                element(1).~T();
+                for (size_t i = 1; i < idx; i++) {
+                    relocate(i , i + 1);
+                }
+            } else {
+                emplace_back(std::move(element(length - 1)));
+                element(length - 2).~T();
+                for (size_t i = length - 2; i > idx; i--) {
+                    relocate(i , i - 1);
+                }
+            }
+            new(&element(idx)) T(std::move(tmp));
+            return iterator(this , idx);
+        }
+
+        /**
+         * removes the element at pos, returns an iterator pointing to the following element.
+         * throw if the container is empty, the iterator is invalid or it points to a wrong place.
+         */
+        iterator erase (iterator pos) {
+            if (pos.thisdeque != this) {
+                throw invalid_iterator();
+            }
+            if (length == 0) {
+                throw container_is_empty();
+            }
+            if (pos.index >= length) {
+                throw invalid_iterator();
+            }
+            size_t idx = pos.index;
+            element(idx).~T();
+            if (idx < length / 2) {
+                for (size_t i = idx; i > 0; i--) {
+                    relocate(i , i - 1);
+                }
+                drop_front();
+            } else {
+                for (size_t i = idx; i + 1 < length; i++) {
+                    relocate(i , i + 1);
+                }
+                drop_back();
+            }
+            return iterator(this , idx);
+        }
+
+        void push_back (const T &value) {
+            emplace_back(value);
+        }
+
+        void push_front (const T &value) {
+            emplace_front(value);
+        }
+
+        /**
+         * removes the last element
+         *     throw when the container is empty.
+         */
+        void pop_back () {
+            if (length == 0) {
+                throw container_is_empty();
+            }
+            element(length - 1).~T();
+            drop_back();
+        }
+
+        /**
+         * removes the first element.
+         *     throw when the container is empty.
+         */
+        void pop_front () {
+            if (length == 0) {
+                throw container_is_empty();
+            }
+            element(0).~T();
+            drop_front();
+        }
+    };
+
+}
+
+#endif
@@ -0,0 +1,190 @@
+//a lock free single producer / single consumer queue on a chain of blocks
+//the producer appends to the tail block, the consumer pops from the head block,
+//and blocks the consumer has left are reused by the producer instead of being freed
+#ifndef SJTU_SPSC_QUEUE_HPP
+#define SJTU_SPSC_QUEUE_HPP
+
+#include <atomic>
+#include <cstddef>
+#include <cstdlib>
+#include <new>
+#include <utility>
+
+namespace sjtu {
+
+    /**
+     * exactly one thread may call push, and exactly one (possibly other) thread may call pop and empty.
+     */
+    template<class T>
+    class spsc_queue {
+    private:
+        static const size_t CACHE_LINE = 64;
+        // about 4KB of elements per block, never less than 16
+        static const size_t BLOCK = sizeof(T) * 16 >= 4096 ? 16 : 4096 / sizeof(T);
+
+        struct block {
+            std::atomic<block *> next;
+            // number of elements the producer has published in this block
+            std::atomic<size_t> written;
+            T *data;
+
+            block () : next(nullptr) , written(0) {
+                data = (T *) malloc(sizeof(T) * BLOCK);
+            }
+
+            ~block () {
+                free(data);
+            }
+        };
+
+        // consumer side
+        alignas(CACHE_LINE) block *head;
+        size_t head_index = 0;
+        // the block the consumer is in, every block before it may be reused
+        std::atomic<block *> consumed;
+
+        // producer side
+        alignas(CACHE_LINE) block *tail;
+        size_t tail_index = 0;
+        // oldest block of the chain, blocks from first up to the consumer's block are free
+        block *first;
+        block *consumed_seen;
+
+        block *acquire () {
+            if (first == consumed_seen) {
+                consumed_seen = consumed.load(std::memory_order_acquire);
+            }
+            if (first != consumed_seen) {
+                auto p = first;
+                first = first->next.load(std::memory_order_relaxed);
+                p->next.store(nullptr , std::memory_order_relaxed);
+                p->written.store(0 , std::memory_order_relaxed);
+                return p;
+            }
+            return new block;
+        }
+
+        template<class V>
+        void emplace (V &&value) {
+            if (tail_index == BLOCK) {
+                auto p = acquire();
+                new(p->data) T(std::forward<V>(value));
+                p->written.store(1 , std::memory_order_relaxed);
+                // publishes the new block together with its first element
+                tail->next.store(p , std::memory_order_release);
+                tail = p;
+                tail_index = 1;
+                return;
+            }
+            new(tail->data + tail_index) T(std::forward<V>(value));
+            tail_index++;
+            tail->written.store(tail_index , std::memory_order_release);
+        }
+
+        // move the consumer to the next block if the current one is drained, return whether an element is ready
+        bool ready () {
+            if (head_index < head->written.load(std::memory_order_acquire)) {
+                return true;
+            }
+            if (head_index < BLOCK) {
+                return false;
+            }
+            auto p = head->next.load(std::memory_order_acquire);
+            if (p == nullptr) {
+                return false;
+            }
+            head = p;
+            head_index = 0;
+            // every element of the old block has been moved out before the producer may see this
+            consumed.store(p , std::memory_order_release);
+            return true;
+        }
+
+    public:
+        spsc_queue () {
+            head = tail = first = consumed_seen = new block;
+            consumed.store(head , std::memory_order_relaxed);
+        }
+
+        /**
+         * before C++17 new ignores an alignment above alignof(std::max_align_t),
+         * so heap instances get their cache line alignment here.
+         */
+        static void *operator new (size_t size) {
+            void *p;
+            if (posix_memalign(&p , CACHE_LINE , size) != 0) {
+                throw std::bad_alloc();
+            }
+            return p;
+        }
+
+        static void *operator new[] (size_t size) {
+            return operator new(size);
+        }
+
+        static void operator delete (void *p) {
+            free(p);
+        }
+
+        static void operator delete[] (void *p) {
+            free(p);
+        }
+
+        spsc_queue (const spsc_queue &other) = delete;
+
+        spsc_queue &operator= (const spsc_queue &other) = delete;
+
+        /**
+         * no other thread may use the queue any more.
+         */
+        ~spsc_queue () {
+            for (auto p = head; p != nullptr; p = p->next.load(std::memory_order_relaxed)) {
+                size_t n = p->written.load(std::memory_order_relaxed);
+                for (size_t i = p == head ? head_index : 0; i < n; i++) {
+                    p->data[i].~T();
+                }
+            }
+            auto p = first;
+            while (p != nullptr) {
+                auto tmp = p;
+                p = p->next.load(std::memory_order_relaxed);
+                delete tmp;
+            }
+        }
+
+        /**
+         * producer only.
+         */
+        void push (const T &value) {
+            emplace(value);
+        }
+
+        void push (T &&value) {
+            emplace(std::move(value));
+        }
+
+        /**
+         * consumer only. move the first element into result, return false if the queue is empty.
+         */
+        bool pop (T &result) {
+            if (!ready()) {
+                return false;
+            }
+            T *p = head->data + head_index;
+            result = std::move(*p);
+            p->~T();
+            head_index++;
+            return true;
+        }
+
+        /**
+         * consumer only.
+         */
+        bool empty () {
+            return !ready();
+        }
+    };
+
+}
+
+#endif
@@ -0,0 +1,183 @@
+//a Chase-Lev work stealing deque on a growable circular array
+//the owner pushes and pops at the bottom, any other thread may steal from the top
+//memory orders follow Le, Pop, Cohen and Zappa Nardelli, "Correct and Efficient Work-Stealing for Weak Memory Models"
+#ifndef SJTU_WORK_STEALING_DEQUE_HPP
+#define SJTU_WORK_STEALING_DEQUE_HPP
+
+#include <atomic>
+#include <cstddef>
+#include <cstdlib>
+#include <new>
+#include <type_traits>
+
+namespace sjtu {
+
+    /**
+     * T is copied while another thread may be racing for the same slot, so it must be trivially copyable
+     * (a task pointer or an index, typically).
+     */
+    template<class T>
+    class work_stealing_deque {
+        static_assert(std::is_trivially_copyable<T>::value , "work_stealing_deque needs a trivially copyable T");
+
+    private:
+        static const size_t CACHE_LINE = 64;
+        static const long long MIN_CAPACITY = 64;
+
+        struct array {
+            long long capacity;
+            long long mask;
+            std::atomic<T> *data;
+            // arrays that have been outgrown, a thief may still be reading them
+            array *older;
+
+            explicit array (long long capacity , array *older = nullptr) : capacity(capacity) , mask(capacity - 1) ,
+                                                                          older(older) {
+                data = new std::atomic<T>[capacity];
+            }
+
+            ~array () {
+                delete[] data;
+            }
+
+            T get (long long i) const {
+                return data[i & mask].load(std::memory_order_relaxed);
+            }
+
+            void put (long long i , T value) {
+                data[i & mask].store(value , std::memory_order_relaxed);
+            }
+        };
+
+        alignas(CACHE_LINE) std::atomic<long long> top;
+        alignas(CACHE_LINE) std::atomic<long long> bottom;
+        std::atomic<array *> items;
+
+        array *grow (array *a , long long b , long long t) {
+            auto tmp = new array(a->capacity * 2 , a);
+            for (long long i = t; i < b; i++) {
+                tmp->put(i , a->get(i));
+            }
+            items.store(tmp , std::memory_order_release);
+            return tmp;
+        }
+
+    public:
+        work_stealing_deque () : top(0) , bottom(0) {
+            items.store(new array(MIN_CAPACITY) , std::memory_order_relaxed);
+        }
+
+        /**
+         * before C++17 new ignores an alignment above alignof(std::max_align_t),
+         * so heap instances get their cache line alignment here.
+         */
+        static void *operator new (size_t size) {
+            void *p;
+            if (posix_memalign(&p , CACHE_LINE , size) != 0) {
+                throw std::bad_alloc();
+            }
+            return p;
+        }
+
+        static void *operator new[] (size_t size) {
+            return operator new(size);
+        }
+
+        static void operator delete (void *p) {
+            free(p);
+        }
+
+        static void operator delete[] (void *p) {
+            free(p);
+        }
+
+        work_stealing_deque (const work_stealing_deque &other) = delete;
+
+        work_stealing_deque &operator= (const work_stealing_deque &other) = delete;
+
+        /**
+         * no other thread may use the deque any more.
+         */
+        ~work_stealing_deque () {
+            auto a = items.load(std::memory_order_relaxed);
+            while (a != nullptr) {
+                auto tmp = a;
+                a = a->older;
+                delete tmp;
+            }
+        }
+
+        /**
+         * owner only.
+         */
+        void push (const T &value) {
+            long long b = bottom.load(std::memory_order_relaxed);
+            long long t = top.load(std::memory_order_acquire);
+            auto a = items.load(std::memory_order_relaxed);
+            if (b - t > a->capacity - 1) {
+                a = grow(a , b , t);
+            }
+            a->put(b , value);
+            std::atomic_thread_fence(std::memory_order_release);
+            bottom.store(b + 1 , std::memory_order_relaxed);
+        }
+
+        /**
+         * owner only. take the most recently pushed element, return false if the deque is empty.
+         */
+        bool pop (T &result) {
+            long long b = bottom.load(std::memory_order_relaxed) - 1;
+            auto a = items.load(std::memory_order_relaxed);
+            bottom.store(b , std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            long long t = top.load(std::memory_order_relaxed);
+            if (t > b) {
+                bottom.store(b + 1 , std::memory_order_relaxed);
+                return false;
+            }
+            result = a->get(b);
+            if (t < b) {
+                return true;
+            }
+            // the last element, race the thieves for it
+            bool won = top.compare_exchange_strong(t , t + 1 , std::memory_order_seq_cst , std::memory_order_relaxed);
+            bottom.store(b + 1 , std::memory_order_relaxed);
+            return won;
+        }
+
+        /**
+         * any thread. take the oldest element, return false if the deque is empty or another thread got it first.
+         */
+        bool steal (T &result) {
+            long long t = top.load(std::memory_order_acquire);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            long long b = bottom.load(std::memory_order_acquire);
+            if (t >= b) {
+                return false;
+            }
+            auto a = items.load(std::memory_order_acquire);
+            T value = a->get(t);
+            if (!top.compare_exchange_strong(t , t + 1 , std::memory_order_seq_cst , std::memory_order_relaxed)) {
+                return false;
+            }
+            result = value;
+            return true;
+        }
+
+        /**
+         * a snapshot that may be stale as soon as it is returned.
+         */
+        size_t size () const {
+            long long b = bottom.load(std::memory_order_relaxed);
+            long long t = top.load(std::memory_order_relaxed);
+            return b > t ? (size_t) (b - t) : 0;
+        }
+
+        bool empty () const {
+            return size() == 0;
+        }
+    };
+
+}
+
+#endif
@@ -0,0 +1,896 @@
+// differential fuzzer: sjtu::vector, sjtu::map and sjtu::deque against std::vector, std::map and std::deque
+// the input bytes decode into a stream of operations that runs on both containers, the results must agree,
+// the sjtu containers must throw where they promise to, and the iterators (references for deque) that the
+// standard keeps valid across an operation must still see the right element afterwards
+//
+// with -DSJTU_LIBFUZZER and -fsanitize=fuzzer it is a libFuzzer target (cmake -DSJTU_LIBFUZZER=ON, clang),
+// otherwise it has its own main:
+//   differential file...                                  replay inputs, e.g. a corpus or a saved crash
+//   differential --random=1000 [--seed=N] [--length=4096]   check random inputs
+//   differential --time [file... | --random=N] [--reps / --warmup / --format / --filter / --clock as in bench.hpp]
+//                                                          per operation throughput of sjtu and std on the same streams
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <deque>
+#include <fstream>
+#include <iterator>
+#include <map>
+#include <set>
+#include <string>
+#include <vector>
+// map first: its exceptions.hpp is the only one that declares InsertionFailure,
+// the other copies share the include guard and are skipped
+#include "../map/map.hpp"
+#include "../vector/vector.hpp"
+#include "../deque/deque.hpp"
+#include "../benchmark/bench.hpp"
+
+enum target { VECTOR, MAP, DEQUE, TARGETS };
+
+const char *target_names[TARGETS] = {"vector", "map", "deque"};
+
+// no container grows past this, operations that would are turned into removals
+const long MAX_SIZE = 4096;
+// map keys are drawn from [0, KEYS) so that lookups hit
+const long KEYS = 1024;
+// at most this many iterators / references are tracked at once
+const size_t MAX_SAVED = 64;
+
+struct op {
+	int kind;
+	long a;
+	int value;
+};
+
+// reads past the end give zeros, so every input decodes
+class reader {
+private:
+	const uint8_t *data;
+	size_t size;
+	size_t pos = 0;
+
+public:
+	reader (const uint8_t *data, size_t size) : data(data), size(size) {}
+
+	bool more () const {
+		return pos < size;
+	}
+
+	uint8_t byte () {
+		return pos < size ? data[pos++] : 0;
+	}
+
+	uint32_t word () {
+		uint32_t w = 0;
+		for (int i = 0; i < 4; i++) {
+			w = w << 8 | byte();
+		}
+		return w;
+	}
+};
+
+const char *current_input = "(input)";
+
+void fail (target t, size_t step, const char *kind, const char *what) {
+	fprintf(stderr, "%s: %s operation %zu (%s): %s\n", current_input, target_names[t], step, kind, what);
+	abort();
+}
+
+template<class Exception, class F>
+bool throws (F f) {
+	try {
+		f();
+	} catch (Exception &) {
+		return true;
+	} catch (...) {
+		return false;
+	}
+	return false;
+}
+
+template<class T>
+typename sjtu::vector<T>::iterator insert_index (sjtu::vector<T> &v, long i, const T &x) {
+	return v.insert((size_t) i, x);
+}
+
+template<class T>
+typename std::vector<T>::iterator insert_index (std::vector<T> &v, long i, const T &x) {
+	return v.insert(v.begin() + i, x);
+}
+
+template<class T>
+typename sjtu::vector<T>::iterator erase_index (sjtu::vector<T> &v, long i) {
+	return v.erase((size_t) i);
+}
+
+template<class T>
+typename std::vector<T>::iterator erase_index (std::vector<T> &v, long i) {
+	return v.erase(v.begin() + i);
+}
+
+template<class C>
+long long hash_forward (C &c) {
+	unsigned long long h = 0;
+	for (auto it = c.begin(); it != c.end(); ++it) {
+		h = h * 1000003 + *it;
+	}
+	return (long long) h;
+}
+
+template<class C>
+long long hash_backward (C &c) {
+	unsigned long long h = 0;
+	if (c.empty()) {
+		return (long long) h;
+	}
+	auto it = c.end();
+	do {
+		--it;
+		h = h * 1000003 + *it;
+	} while (it != c.begin());
+	return (long long) h;
+}
+
+namespace vector_ops {
+
+	enum kind {
+		PUSH_BACK, POP_BACK, INSERT, INSERT_INDEX, ERASE, ERASE_INDEX, ASSIGN, READ, FRONT_BACK, ITERATE, CLEAR,
+		COPY, SAVE, BAD_AT, BAD_POP, KINDS
+	};
+
+	const char *names[KINDS] = {"push_back", "pop_back", "insert", "insert_index", "erase", "erase_index", "assign",
+	                            "read", "front_back", "iterate", "clear", "copy", "save", "bad_at", "bad_pop"};
+
+	std::vector<op> decode (reader &in) {
+		std::vector<op> ops;
+		long size = 0;
+		while (in.more()) {
+			op o;
+			o.kind = in.byte() % KINDS;
+			o.a = in.word();
+			o.value = (int) in.word();
+			bool grows = o.kind == PUSH_BACK || o.kind == INSERT || o.kind == INSERT_INDEX;
+			bool needs_element = o.kind == POP_BACK || o.kind == ERASE || o.kind == ERASE_INDEX || o.kind == ASSIGN ||
+			                     o.kind == READ || o.kind == FRONT_BACK || o.kind == SAVE;
+			if (grows && size >= MAX_SIZE) {
+				o.kind = POP_BACK;
+			} else if (needs_element && size == 0) {
+				o.kind = o.kind == POP_BACK ? BAD_POP : PUSH_BACK;
+			} else if (o.kind == BAD_POP && size > 0) {
+				o.kind = POP_BACK;
+			}
+			switch (o.kind) {
+				case INSERT:
+				case INSERT_INDEX:
+					o.a %= size + 1;
+					break;
+				case ERASE:
+				case ERASE_INDEX:
+				case ASSIGN:
+				case READ:
+				case SAVE:
+					o.a %= size;
+					break;
+				case BAD_AT:
+					o.a = size + o.a % 4;
+					break;
+			}
+			if (o.kind == PUSH_BACK || o.kind == INSERT || o.kind == INSERT_INDEX) {
+				size++;
+			} else if (o.kind == POP_BACK || o.kind == ERASE || o.kind == ERASE_INDEX) {
+				size--;
+			} else if (o.kind == CLEAR) {
+				size = 0;
+			}
+			ops.push_back(o);
+		}
+		return ops;
+	}
+
+	// the observable result of one operation, the same for both containers when they agree
+	template<class C>
+	long long execute (C &c, const op &o) {
+		switch (o.kind) {
+			case PUSH_BACK:
+				c.push_back(o.value);
+				return (long long) c.size();
+			case POP_BACK:
+				c.pop_back();
+				return (long long) c.size();
+			case INSERT: {
+				auto it = c.insert(c.begin() + (int) o.a, o.value);
+				return *it + (it - c.begin()) * 7;
+			}
+			case INSERT_INDEX: {
+				auto it = insert_index(c, o.a, o.value);
+				return *it + (it - c.begin()) * 7;
+			}
+			case ERASE: {
+				auto it = c.erase(c.begin() + (int) o.a);
+				return it == c.end() ? -1 : *it + (it - c.begin()) * 7;
+			}
+			case ERASE_INDEX: {
+				auto it = erase_index(c, o.a);
+				return it == c.end() ? -1 : *it + (it - c.begin()) * 7;
+			}
+			case ASSIGN:
+				c[o.a] = o.value;
+				return c[o.a];
+			case READ:
+			case SAVE:
+				return o.value % 2 == 0 ? c[o.a] : c.at(o.a);
+			case FRONT_BACK:
+				return c.front() * 3LL + c.back();
+			case ITERATE:
+				return hash_forward(c);
+			case CLEAR:
+				c.clear();
+				return (long long) c.size();
+			case COPY: {
+				C tmp(c);
+				c = tmp;
+				return (long long) c.size();
+			}
+		}
+		return 0;
+	}
+
+	void check (const std::vector<op> &ops) {
+		sjtu::vector<int> s;
+		std::vector<int> r;
+		struct saved {
+			long index;
+			sjtu::vector<int>::iterator it;
+		};
+		std::vector<saved> its;
+		for (size_t step = 0; step < ops.size(); step++) {
+			const op &o = ops[step];
+			if (o.kind == BAD_AT) {
+				if (!throws<sjtu::index_out_of_bound>([&] { bench::keep(s.at(o.a)); })) {
+					fail(VECTOR, step, names[o.kind], "at() past the end did not throw index_out_of_bound");
+				}
+				continue;
+			}
+			if (o.kind == BAD_POP) {
+				if (!throws<sjtu::container_is_empty>([&] { s.pop_back(); })) {
+					fail(VECTOR, step, names[o.kind], "pop_back() on an empty vector did not throw container_is_empty");
+				}
+				continue;
+			}
+			size_t capacity = s.capacity();
+			long long observed = 0;
+			try {
+				observed = execute(s, o);
+			} catch (...) {
+				fail(VECTOR, step, names[o.kind], "a valid operation threw");
+			}
+			if (observed != execute(r, o)) {
+				fail(VECTOR, step, names[o.kind], "results differ");
+			}
+			if (s.size() != r.size()) {
+				fail(VECTOR, step, names[o.kind], "sizes differ");
+			}
+			// iterators at or after the changed position are invalidated, all of them on reallocation
+			long first = 0;
+			switch (o.kind) {
+				case INSERT:
+				case INSERT_INDEX:
+				case ERASE:
+				case ERASE_INDEX:
+					first = o.a;
+					break;
+				case PUSH_BACK:
+				case POP_BACK:
+					first = (long) r.size() - (o.kind == PUSH_BACK);
+					break;
+				case CLEAR:
+				case COPY:
+					first = 0;
+					break;
+				default:
+					first = MAX_SIZE;
+			}
+			if (s.capacity() != capacity) {
+				first = 0;
+			}
+			for (size_t i = 0; i < its.size();) {
+				if (its[i].index >= first) {
+					its.erase(its.begin() + i);
+				} else {
+					i++;
+				}
+			}
+			if (o.kind == SAVE && its.size() < MAX_SAVED) {
+				its.push_back(saved{o.a, s.begin() + (int) o.a});
+			}
+			for (auto &i : its) {
+				if (*i.it != r[i.index]) {
+					fail(VECTOR, step, names[o.kind], "an iterator that must stay valid sees another element");
+				}
+			}
+			if (step % 16 == 15 || step + 1 == ops.size()) {
+				for (size_t i = 0; i < r.size(); i++) {
+					if (s[i] != r[i]) {
+						fail(VECTOR, step, names[o.kind], "contents differ");
+					}
+				}
+			}
+		}
+	}
+
+}
+
+namespace map_ops {
+
+	enum kind {
+		INSERT, SET, GET, AT, FIND, COUNT, ERASE, ITERATE, ITERATE_BACK, CLEAR, COPY, SAVE, BAD_AT, BAD_ERASE, BAD_STEP,
+		KINDS
+	};
+
+	const char *names[KINDS] = {"insert", "set", "get", "at", "find", "count", "erase", "iterate", "iterate_back",
+	                            "clear", "copy", "save", "bad_at", "bad_erase", "bad_step"};
+
+	std::vector<op> decode (reader &in) {
+		std::vector<op> ops;
+		std::set<long> keys;
+		while (in.more()) {
+			op o;
+			o.kind = in.byte() % KINDS;
+			o.a = in.word() % KEYS;
+			o.value = (int) in.word();
+			bool present = keys.count(o.a) > 0;
+			if ((o.kind == AT || o.kind == ERASE || o.kind == SAVE) && !present) {
+				o.kind = o.kind == ERASE ? FIND : SET;
+			}
+			if (o.kind == BAD_AT) {
+				o.a += KEYS;
+			}
+			if (o.kind == INSERT || o.kind == SET || o.kind == GET || o.kind == SAVE) {
+				keys.insert(o.a);
+			} else if (o.kind == ERASE) {
+				keys.erase(o.a);
+			} else if (o.kind == CLEAR) {
+				keys.clear();
+			}
+			ops.push_back(o);
+		}
+		return ops;
+	}
+
+	template<class C>
+	long long hash_entries (C &c, bool backward) {
+		unsigned long long h = 0;
+		if (!backward) {
+			for (auto it = c.begin(); it != c.end(); ++it) {
+				h = (h * 1000003 + it->first) * 31 + it->second;
+			}
+		} else if (!c.empty()) {
+			auto it = c.end();
+			do {
+				--it;
+				h = (h * 1000003 + it->first) * 31 + it->second;
+			} while (it != c.begin());
+		}
+		return (long long) h;
+	}
+
+	template<class C>
+	long long execute (C &c, const op &o) {
+		int key = (int) o.a;
+		switch (o.kind) {
+			case INSERT: {
+				auto result = c.insert(typename C::value_type(key, o.value));
+				return (result.first->first * 2LL + result.first->second) * 2 + result.second;
+			}
+			case SET:
+			case SAVE:
+				c[key] = o.value;
+				return (long long) c.size();
+			case GET:
+				return c[key];
+			case AT:
+				return c.at(key);
+			case FIND: {
+				auto it = c.find(key);
+				return it == c.end() ? -1 : it->second * 2LL + 1;
+			}
+			case COUNT:
+				return (long long) c.count(key);
+			case ERASE:
+				c.erase(c.find(key));
+				return (long long) c.size();
+			case ITERATE:
+				return hash_entries(c, false);
+			case ITERATE_BACK:
+				return hash_entries(c, true);
+			case CLEAR:
+				c.clear();
+				return (long long) c.size();
+			case COPY: {
+				C tmp(c);
+				c = tmp;
+				return (long long) c.size();
+			}
+		}
+		return 0;
+	}
+
+	void check (const std::vector<op> &ops) {
+		typedef sjtu::map<int, int> map;
+		map s;
+		std::map<int, int> r;
+		struct saved {
+			int key;
+			map::iterator it;
+		};
+		std::vector<saved> its;
+		for (size_t step = 0; step < ops.size(); step++) {
+			const op &o = ops[step];
+			if (o.kind == BAD_AT) {
+				if (!throws<sjtu::index_out_of_bound>([&] { bench::keep(s.at((int) o.a)); })) {
+					fail(MAP, step, names[o.kind], "at() of a missing key did not throw index_out_of_bound");
+				}
+				continue;
+			}
+			if (o.kind == BAD_ERASE) {
+				if (!throws<sjtu::invalid_iterator>([&] { s.erase(s.end()); })) {
+					fail(MAP, step, names[o.kind], "erase(end()) did not throw invalid_iterator");
+				}
+				continue;
+			}
+			if (o.kind == BAD_STEP) {
+				bool thrown = o.value % 2 == 0 ? throws<sjtu::invalid_iterator>([&] { ++s.end(); })
+				                               : throws<sjtu::invalid_iterator>([&] { --s.begin(); });
+				if (!thrown) {
+					fail(MAP, step, names[o.kind], "stepping out of the map did not throw invalid_iterator");
+				}
+				continue;
+			}
+			long long observed = 0;
+			try {
+				observed = execute(s, o);
+			} catch (...) {
+				fail(MAP, step, names[o.kind], "a valid operation threw");
+			}
+			if (observed != execute(r, o)) {
+				fail(MAP, step, names[o.kind], "results differ");
+			}
+			if (s.size() != r.size()) {
+				fail(MAP, step, names[o.kind], "sizes differ");
+			}
+			// only erasing an entry invalidates iterators, and only the ones to that entry
+			for (size_t i = 0; i < its.size();) {
+				if (o.kind == CLEAR || o.kind == COPY || (o.kind == ERASE && its[i].key == o.a)) {
+					its.erase(its.begin() + i);
+				} else {
+					i++;
+				}
+			}
+			if (o.kind == SAVE && its.size() < MAX_SAVED) {
+				its.push_back(saved{(int) o.a, s.find((int) o.a)});
+			}
+			for (auto &i : its) {
+				if (i.it->first != i.key || i.it->second != r[i.key]) {
+					fail(MAP, step, names[o.kind], "an iterator that must stay valid sees another entry");
+				}
+			}
+			if (step % 16 == 15 || step + 1 == ops.size()) {
+				auto j = s.begin();
+				for (auto i = r.begin(); i != r.end(); ++i, ++j) {
+					if (j == s.end() || j->first != i->first || j->second != i->second) {
+						fail(MAP, step, names[o.kind], "contents differ");
+					}
+				}
+			}
+		}
+	}
+
+}
+
+namespace deque_ops {
+
+	enum kind {
+		PUSH_BACK, PUSH_FRONT, POP_BACK, POP_FRONT, INSERT, ERASE, READ, ASSIGN, FRONT_BACK, ITERATE, ITERATE_BACK,
+		ARITH, CLEAR, COPY, SAVE, BAD_AT, BAD_POP, KINDS
+	};
+
+	const char *names[KINDS] = {"push_back", "push_front", "pop_back", "pop_front", "insert", "erase", "read",
+	                            "assign", "front_back", "iterate", "iterate_back", "arith", "clear", "copy", "save",
+	                            "bad_at", "bad_pop"};
+
+	std::vector<op> decode (reader &in) {
+		std::vector<op> ops;
+		long size = 0;
+		while (in.more()) {
+			op o;
+			o.kind = in.byte() % KINDS;
+			o.a = in.word();
+			o.value = (int) in.word();
+			bool grows = o.kind == PUSH_BACK || o.kind == PUSH_FRONT || o.kind == INSERT;
+			bool needs_element = o.kind == POP_BACK || o.kind == POP_FRONT || o.kind == ERASE || o.kind == READ ||
+			                     o.kind == ASSIGN || o.kind == FRONT_BACK || o.kind == ARITH || o.kind == SAVE;
+			if (grows && size >= MAX_SIZE) {
+				o.kind = o.kind == PUSH_FRONT ? POP_FRONT : POP_BACK;
+			} else if (needs_element && size == 0) {
+				o.kind = o.kind == POP_BACK || o.kind == POP_FRONT ? BAD_POP : PUSH_FRONT;
+			} else if (o.kind == BAD_POP && size > 0) {
+				o.kind = o.value % 2 == 0 ? POP_BACK : POP_FRONT;
+			}
+			switch (o.kind) {
+				case INSERT:
+					o.a %= size + 1;
+					break;
+				case ERASE:
+				case READ:
+				case ASSIGN:
+				case ARITH:
+				case SAVE:
+					o.a %= size;
+					break;
+				case BAD_AT:
+					o.a = size + o.a % 4;
+					break;
+			}
+			if (o.kind == PUSH_BACK || o.kind == PUSH_FRONT || o.kind == INSERT) {
+				size++;
+			} else if (o.kind == POP_BACK || o.kind == POP_FRONT || o.kind == ERASE) {
+				size--;
+			} else if (o.kind == CLEAR) {
+				size = 0;
+			}
+			ops.push_back(o);
+		}
+		return ops;
+	}
+
+	template<class C>
+	long long execute (C &c, const op &o) {
+		switch (o.kind) {
+			case PUSH_BACK:
+				c.push_back(o.value);
+				return (long long) c.size();
+			case PUSH_FRONT:
+				c.push_front(o.value);
+				return (long long) c.size();
+			case POP_BACK:
+				c.pop_back();
+				return (long long) c.size();
+			case POP_FRONT:
+				c.pop_front();
+				return (long long) c.size();
+			case INSERT: {
+				auto it = c.insert(c.begin() + (int) o.a, o.value);
+				return *it + (it - c.begin()) * 7;
+			}
+			case ERASE: {
+				auto it = c.erase(c.begin() + (int) o.a);
+				return it == c.end() ? -1 : *it + (it - c.begin()) * 7;
+			}
+			case READ:
+			case SAVE:
+				return o.value % 2 == 0 ? c[o.a] : c.at(o.a);
+			case ASSIGN:
+				c[o.a] = o.value;
+				return c[o.a];
+			case FRONT_BACK:
+				return c.front() * 3LL + c.back();
+			case ITERATE:
+				return hash_forward(c);
+			case ITERATE_BACK:
+				return hash_backward(c);
+			case ARITH: {
+				auto it = c.begin() + (int) o.a;
+				return *it + (c.end() - it) * 7 + (it - c.begin()) * 13;
+			}
+			case CLEAR:
+				c.clear();
+				return (long long) c.size();
+			case COPY: {
+				C tmp(c);
+				c = tmp;
+				return (long long) c.size();
+			}
+		}
+		return 0;
+	}
+
+	void check (const std::vector<op> &ops) {
+		sjtu::deque<int> s;
+		std::deque<int> r;
+		// references to the other elements survive push and pop at either end
+		struct saved {
+			long index;
+			const int *element;
+		};
+		std::vector<saved> refs;
+		for (size_t step = 0; step < ops.size(); step++) {
+			const op &o = ops[step];
+			if (o.kind == BAD_AT) {
+				if (!throws<sjtu::index_out_of_bound>([&] { bench::keep(s.at(o.a)); })) {
+					fail(DEQUE, step, names[o.kind], "at() past the end did not throw index_out_of_bound");
+				}
+				continue;
+			}
+			if (o.kind == BAD_POP) {
+				bool thrown = o.value % 2 == 0 ? throws<sjtu::container_is_empty>([&] { s.pop_back(); })
+				                               : throws<sjtu::container_is_empty>([&] { s.pop_front(); });
+				if (!thrown) {
+					fail(DEQUE, step, names[o.kind], "pop on an empty deque did not throw container_is_empty");
+				}
+				continue;
+			}
+			long long observed = 0;
+			try {
+				observed = execute(s, o);
+			} catch (...) {
+				fail(DEQUE, step, names[o.kind], "a valid operation threw");
+			}
+			if (observed != execute(r, o)) {
+				fail(DEQUE, step, names[o.kind], "results differ");
+			}
+			if (s.size() != r.size()) {
+				fail(DEQUE, step, names[o.kind], "sizes differ");
+			}
+			for (size_t i = 0; i < refs.size();) {
+				bool dropped = false;
+				switch (o.kind) {
+					case PUSH_FRONT:
+						refs[i].index++;
+						break;
+					case POP_FRONT:
+						dropped = refs[i].index-- == 0;
+						break;
+					case POP_BACK:
+						dropped = refs[i].index == (long) r.size();
+						break;
+					case INSERT:
+					case ERASE:
+					case CLEAR:
+					case COPY:
+						dropped = true;
+						break;
+				}
+				if (dropped) {
+					refs.erase(refs.begin() + i);
+				} else {
+					i++;
+				}
+			}
+			if (o.kind == SAVE && refs.size() < MAX_SAVED) {
+				refs.push_back(saved{o.a, &s[o.a]});
+			}
+			for (auto &i : refs) {
+				if (*i.element != r[i.index]) {
+					fail(DEQUE, step, names[o.kind], "a reference that must stay valid sees another element");
+				}
+			}
+			if (step % 16 == 15 || step + 1 == ops.size()) {
+				for (size_t i = 0; i < r.size(); i++) {
+					if (s[i] != r[i]) {
+						fail(DEQUE, step, names[o.kind], "contents differ");
+					}
+				}
+			}
+		}
+	}
+
+}
+
+// the first byte picks the container, the rest is its operation stream
+size_t check (const uint8_t *data, size_t size) {
+	if (size == 0) {
+		return 0;
+	}
+	reader in(data + 1, size - 1);
+	switch (data[0] % TARGETS) {
+		case VECTOR: {
+			auto ops = vector_ops::decode(in);
+			vector_ops::check(ops);
+			return ops.size();
+		}
+		case MAP: {
+			auto ops = map_ops::decode(in);
+			map_ops::check(ops);
+			return ops.size();
+		}
+		default: {
+			auto ops = deque_ops::decode(in);
+			deque_ops::check(ops);
+			return ops.size();
+		}
+	}
+}
+
+#ifdef SJTU_LIBFUZZER
+
+extern "C" int LLVMFuzzerTestOneInput (const uint8_t *data, size_t size) {
+	check(data, size);
+	return 0;
+}
+
+#else
+
+double now () {
+	return (double) std::chrono::duration_cast<std::chrono::nanoseconds>(
+			std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+// per operation kind: how many ran and the time they took, in ns
+struct profile {
+	std::vector<long> count;
+	std::vector<double> ns;
+
+	explicit profile (int kinds) : count(kinds), ns(kinds) {}
+};
+
+// every operation is timed on its own in a single pass, a breakdown by kind rather than a measurement to compare
+template<class C, class Execute>
+void timed (const std::vector<op> &ops, int invalid, Execute execute, profile &p) {
+	double overhead = now();
+	for (int i = 0; i < 1000; i++) {
+		bench::keep(now());
+	}
+	overhead = (now() - overhead) / 1001;
+	C c;
+	for (auto &o : ops) {
+		if (o.kind >= invalid) {
+			continue;
+		}
+		double begin = now();
+		bench::keep(execute(c, o));
+		double elapsed = now() - begin - overhead;
+		p.count[o.kind]++;
+		p.ns[o.kind] += elapsed > 0 ? elapsed : 0;
+	}
+}
+
+// the whole stream without per operation clock reads, with warmup and repetitions so that runs can be compared
+template<class C, class Execute>
+void stream (bench::runner &run, const char *container, const char *impl, const std::string &name,
+             const std::vector<op> &ops, int invalid, Execute execute) {
+	long valid = 0;
+	for (auto &o : ops) {
+		valid += o.kind < invalid;
+	}
+	run.measure(container, impl, name, (long) ops.size(), valid, [] { return C(); }, [&] (C &c) {
+		for (auto &o : ops) {
+			if (o.kind < invalid) {
+				bench::keep(execute(c, o));
+			}
+		}
+	});
+}
+
+void report (const char *container, const char *const names[], int kinds, const profile &s, const profile &r) {
+	for (int k = 0; k < kinds; k++) {
+		if (s.count[k] == 0) {
+			continue;
+		}
+		double sns = s.ns[k] / s.count[k], rns = r.ns[k] / r.count[k];
+		printf("%-8s %-14s %10ld %12.1f %12.1f %8.2fx\n", container, names[k], s.count[k], sns, rns,
+		       rns > 0 ? sns / rns : 0.0);
+	}
+}
+
+std::vector<uint8_t> random_input (bench::rng &random, int target, size_t length) {
+	std::vector<uint8_t> data(length);
+	data[0] = (uint8_t) target;
+	for (size_t i = 1; i < length; i++) {
+		data[i] = (uint8_t) random.next();
+	}
+	return data;
+}
+
+int main (int argc, char *argv[]) {
+	long count = 0;
+	std::uint64_t seed = 20190401;
+	size_t length = 0;
+	bool timing = false;
+	std::vector<std::string> files;
+	// the timing options go to bench::parse
+	std::vector<char *> rest(1, argv[0]);
+	for (int i = 1; i < argc; i++) {
+		std::string arg = argv[i];
+		if (arg.compare(0, 9, "--random=") == 0) {
+			count = atol(arg.c_str() + 9);
+		} else if (arg.compare(0, 7, "--seed=") == 0) {
+			seed = strtoull(arg.c_str() + 7, nullptr, 10);
+		} else if (arg.compare(0, 9, "--length=") == 0) {
+			length = (size_t) atol(arg.c_str() + 9);
+		} else if (arg == "--time") {
+			timing = true;
+		} else if (arg.compare(0, 2, "--") == 0) {
+			rest.push_back(argv[i]);
+		} else {
+			files.push_back(arg);
+		}
+	}
+	if (length < 2) {
+		length = timing ? 1 << 20 : 4096;
+	}
+	if (files.empty() && count == 0) {
+		count = timing ? 3 : 1000;
+	}
+	std::vector<std::vector<uint8_t>> inputs;
+	for (auto &name : files) {
+		std::ifstream in(name, std::ios::binary);
+		if (!in) {
+			fprintf(stderr, "cannot read %s\n", name.c_str());
+			return 1;
+		}
+		inputs.emplace_back(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+	}
+	bench::rng random(seed);
+	for (long i = 0; i < count; i++) {
+		inputs.push_back(random_input(random, (int) (i % TARGETS), length));
+	}
+
+	if (!timing) {
+		size_t ops = 0;
+		for (size_t i = 0; i < inputs.size(); i++) {
+			std::string name = i < files.size() ? files[i] : "random input " + std::to_string(i - files.size());
+			current_input = name.c_str();
+			ops += check(inputs[i].data(), inputs[i].size());
+		}
+		printf("%zu inputs, %zu operations, no differences\n", inputs.size(), ops);
+		return 0;
+	}
+
+	bench::runner run(bench::parse((int) rest.size(), rest.data()));
+	profile vs(vector_ops::KINDS), vr(vector_ops::KINDS);
+	profile ms(map_ops::KINDS), mr(map_ops::KINDS);
+	profile ds(deque_ops::KINDS), dr(deque_ops::KINDS);
+	for (size_t i = 0; i < inputs.size(); i++) {
+		auto &input = inputs[i];
+		if (input.empty()) {
+			continue;
+		}
+		std::string name = i < files.size() ? files[i].substr(files[i].find_last_of('/') + 1)
+		                                    : "random " + std::to_string(i - files.size());
+		reader in(input.data() + 1, input.size() - 1);
+		switch (input[0] % TARGETS) {
+			case VECTOR: {
+				auto ops = vector_ops::decode(in);
+				timed<sjtu::vector<int>>(ops, vector_ops::BAD_AT, vector_ops::execute<sjtu::vector<int>>, vs);
+				timed<std::vector<int>>(ops, vector_ops::BAD_AT, vector_ops::execute<std::vector<int>>, vr);
+				stream<sjtu::vector<int>>(run, "vector", "sjtu::vector", name, ops, vector_ops::BAD_AT,
+				                          vector_ops::execute<sjtu::vector<int>>);
+				stream<std::vector<int>>(run, "vector", "std::vector", name, ops, vector_ops::BAD_AT,
+				                         vector_ops::execute<std::vector<int>>);
+				break;
+			}
+			case MAP: {
+				auto ops = map_ops::decode(in);
+				timed<sjtu::map<int, int>>(ops, map_ops::BAD_AT, map_ops::execute<sjtu::map<int, int>>, ms);
+				timed<std::map<int, int>>(ops, map_ops::BAD_AT, map_ops::execute<std::map<int, int>>, mr);
+				stream<sjtu::map<int, int>>(run, "map", "sjtu::map", name, ops, map_ops::BAD_AT,
+				                            map_ops::execute<sjtu::map<int, int>>);
+				stream<std::map<int, int>>(run, "map", "std::map", name, ops, map_ops::BAD_AT,
+				                           map_ops::execute<std::map<int, int>>);
+				break;
+			}
+			default: {
+				auto ops = deque_ops::decode(in);
+				timed<sjtu::deque<int>>(ops, deque_ops::BAD_AT, deque_ops::execute<sjtu::deque<int>>, ds);
+				timed<std::deque<int>>(ops, deque_ops::BAD_AT, deque_ops::execute<std::deque<int>>, dr);
+				stream<sjtu::deque<int>>(run, "deque", "sjtu::deque", name, ops, deque_ops::BAD_AT,
+				                         deque_ops::execute<sjtu::deque<int>>);
+				stream<std::deque<int>>(run, "deque", "std::deque", name, ops, deque_ops::BAD_AT,
+				                        deque_ops::execute<std::deque<int>>);
+			}
+		}
+	}
+	printf("%-8s %-14s %10s %12s %12s %9s   (ns per operation, one pass)\n", "", "op", "count", "sjtu", "std",
+	       "vs std");
+	report("vector", vector_ops::names, vector_ops::KINDS, vs, vr);
+	report("map", map_ops::names, map_ops::KINDS, ms, mr);
+	report("deque", deque_ops::names, deque_ops::KINDS, ds, dr);
+	printf("\n");
+	run.report();
+	return 0;
+}
+
+#endif
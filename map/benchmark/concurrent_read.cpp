@@ -0,0 +1,116 @@
+// read-heavy scaling: sjtu::map behind a global mutex vs sjtu::concurrent_map
+// usage: concurrent_read [keys] [milliseconds per run] [max threads]
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "../map.hpp"
+#include "../concurrent_map.hpp"
+
+struct locked_map {
+	sjtu::map<int, int> map;
+	mutable std::mutex lock;
+
+	bool find (int key, int &result) const {
+		std::lock_guard<std::mutex> guard(lock);
+		auto it = const_cast<sjtu::map<int, int> &>(map).find(key);
+		if (it == const_cast<sjtu::map<int, int> &>(map).end()) return false;
+		result = it->second;
+		return true;
+	}
+
+	void assign (int key, int val) {
+		std::lock_guard<std::mutex> guard(lock);
+		map[key] = val;
+	}
+
+	void erase (int key) {
+		std::lock_guard<std::mutex> guard(lock);
+		auto it = map.find(key);
+		if (it != map.end()) map.erase(it);
+	}
+};
+
+struct lockfree_map {
+	sjtu::concurrent_map<int, int> map;
+
+	bool find (int key, int &result) const {
+		return map.find(key, result);
+	}
+
+	void assign (int key, int val) {
+		map.assign(sjtu::pair<int, int>(key, val));
+	}
+
+	void erase (int key) {
+		map.erase(key);
+	}
+};
+
+// readers look up random keys while one writer keeps inserting and erasing
+template<class Map>
+double run (Map &map, int keys, int readers, int millis) {
+	std::atomic<bool> start(false), stop(false);
+	std::atomic<long long> total(0);
+	std::vector<std::thread> threads;
+	for (int t = 0; t < readers; t++) {
+		threads.emplace_back([&, t] {
+			unsigned seed = 2654435761u * (t + 1);
+			long long ops = 0;
+			int value, found = 0;
+			while (!start.load()) std::this_thread::yield();
+			while (!stop.load(std::memory_order_relaxed)) {
+				for (int i = 0; i < 256; i++) {
+					seed = seed * 1103515245u + 12345u;
+					found += map.find((seed >> 4) % keys, value);
+				}
+				ops += 256;
+			}
+			total += ops + (found < 0);
+		});
+	}
+	threads.emplace_back([&] {
+		unsigned seed = 12345;
+		while (!start.load()) std::this_thread::yield();
+		while (!stop.load(std::memory_order_relaxed)) {
+			seed = seed * 1103515245u + 12345u;
+			int key = (seed >> 4) % keys;
+			if (seed & 1) map.assign(key, key);
+			else map.erase(key);
+			std::this_thread::yield();
+		}
+	});
+	auto begin = std::chrono::steady_clock::now();
+	start = true;
+	std::this_thread::sleep_for(std::chrono::milliseconds(millis));
+	stop = true;
+	for (auto &t : threads) t.join();
+	double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+	return total.load() / seconds / 1e6;
+}
+
+int main (int argc, char *argv[]) {
+	int keys = argc > 1 ? atoi(argv[1]) : 1000000;
+	int millis = argc > 2 ? atoi(argv[2]) : 1000;
+	int max_threads = argc > 3 ? atoi(argv[3]) : (int) std::thread::hardware_concurrency();
+	if (max_threads < 1) max_threads = 1;
+
+	locked_map locked;
+	lockfree_map lockfree;
+	for (int i = 0; i < keys; i += 2) {
+		locked.assign(i, i);
+		lockfree.assign(i, i);
+	}
+	printf("keys=%d, one writer, %d ms per run\n", keys, millis);
+	printf("%8s %22s %22s\n", "readers", "mutex map (Mops/s)", "concurrent (Mops/s)");
+	for (int readers = 1; readers <= max_threads; readers *= 2) {
+		double a = run(locked, keys, readers, millis);
+		double b = run(lockfree, keys, readers, millis);
+		printf("%8d %22.2f %22.2f\n", readers, a, b);
+	}
+	return 0;
+}
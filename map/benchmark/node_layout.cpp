@@ -0,0 +1,72 @@
+// bytes per entry, insert and lookup throughput of sjtu::map and sjtu::compact_map
+// usage: node_layout [elements]
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+#if defined(__GLIBC__)
+#include <malloc.h>
+#endif
+#include "../map.hpp"
+#include "../compact_map.hpp"
+
+// bytes handed out by malloc, including its per-chunk header and rounding
+static long long heap_in_use () {
+#if defined(__GLIBC__) && (__GLIBC__ > 2 || __GLIBC_MINOR__ >= 33)
+	return (long long) mallinfo2().uordblks;
+#elif defined(__GLIBC__)
+	return (long long) mallinfo().uordblks;
+#else
+	return 0;
+#endif
+}
+
+template<class Map, class Key>
+void run (const char *name, int n) {
+	std::vector<Key> keys;
+	unsigned seed = 20190401;
+	for (int i = 0; i < n; i++) {
+		seed = seed * 1103515245u + 12345u;
+		keys.push_back((Key) seed * 7919 + i);
+	}
+	long long before = heap_in_use();
+	Map *map = new Map;
+	long long sink = 0;
+	auto begin = std::chrono::steady_clock::now();
+	// insert returns an iterator, the half of the keys inserted twice exercise the existing key path
+	for (int i = 0; i < n; i++) {
+		sink += map->insert(typename Map::value_type(keys[i], (Key) i)).second;
+		sink -= map->insert(typename Map::value_type(keys[i / 2], (Key) i)).second;
+	}
+	double inserting = std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+	long long bytes = heap_in_use() - before;
+	begin = std::chrono::steady_clock::now();
+	for (int round = 0; round < 5; round++) {
+		for (int i = 0; i < n; i++) {
+			sink += map->count(keys[(i * 40503u) % n]);
+		}
+	}
+	double counting = std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+	begin = std::chrono::steady_clock::now();
+	for (int round = 0; round < 5; round++) {
+		for (int i = 0; i < n; i++) {
+			sink += map->find(keys[(i * 40503u) % n]) != map->end();
+		}
+	}
+	double finding = std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+	printf("  %-28s sizeof(Entry)=%3d  heap bytes/entry=%6.1f  inserts/s=%6.2fM  counts/s=%6.2fM  finds/s=%6.2fM  (%lld)\n",
+	       name, (int) sizeof(typename Map::Entry), bytes / (double) n, 2.0 * n / inserting / 1e6,
+	       5.0 * n / counting / 1e6, 5.0 * n / finding / 1e6, sink - 11LL * n);
+	delete map;
+}
+
+int main (int argc, char *argv[]) {
+	int n = argc > 1 ? atoi(argv[1]) : 1000000;
+	printf("n=%d\n", n);
+	run<sjtu::map<int, int>, int>("map<int,int>", n);
+	run<sjtu::compact_map<int, int>, int>("compact_map<int,int>", n);
+	run<sjtu::map<long long, long long>, long long>("map<int64,int64>", n);
+	run<sjtu::compact_map<long long, long long>, long long>("compact_map<int64,int64>", n);
+	return 0;
+}
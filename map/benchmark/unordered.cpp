@@ -0,0 +1,106 @@
+// sjtu::map vs sjtu::unordered_map on operator[], find, count and erase
+// usage: unordered [elements]
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <sstream>
+#include <string>
+#include <vector>
+#include "../map.hpp"
+#include "../unordered_map.hpp"
+#include "../data/class-bint.hpp"
+
+// the int wrapper used by data/four
+class IntA {
+public:
+	static int counter;
+	int val;
+
+	IntA (int val) : val(val) { counter++; }
+
+	IntA (const IntA &rhs) : val(rhs.val) { counter++; }
+
+	~IntA () { counter--; }
+
+	bool operator== (const IntA &rhs) const { return val == rhs.val; }
+
+	friend bool operator< (const IntA &lhs, const IntA &rhs) { return lhs.val > rhs.val; }
+};
+
+int IntA::counter = 0;
+
+struct IntAHash {
+	size_t operator() (const IntA &a) const { return std::hash<int>()(a.val); }
+};
+
+// Bint only exposes its digits through operator<<
+struct BintHash {
+	size_t operator() (const Util::Bint &b) const {
+		std::ostringstream os;
+		os << b;
+		return std::hash<std::string>()(os.str());
+	}
+};
+
+IntA make_key (int x, IntA *) { return IntA(x); }
+
+std::string make_key (int x, std::string *) { return "key-" + std::to_string(x * 2654435761u); }
+
+Util::Bint make_key (int x, Util::Bint *) { return Util::Bint(1000000007LL * x + 998244353LL); }
+
+template<class F>
+double seconds (F f) {
+	auto begin = std::chrono::steady_clock::now();
+	f();
+	return std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+}
+
+template<class Map, class Key>
+void run (const char *name, const std::vector<Key> &keys, const std::vector<Key> &missing) {
+	Map map;
+	long long sink = 0;
+	double t_insert = seconds([&] {
+		for (size_t i = 0; i < keys.size(); i++) map[keys[i]] = (int) i;
+	});
+	double t_hit = seconds([&] {
+		for (size_t i = 0; i < keys.size(); i++) sink += map.find(keys[i])->second;
+	});
+	double t_miss = seconds([&] {
+		for (size_t i = 0; i < missing.size(); i++) sink += map.count(missing[i]);
+	});
+	double t_erase = seconds([&] {
+		for (size_t i = 0; i < keys.size(); i++) map.erase(map.find(keys[i]));
+	});
+	double n = keys.size() / 1e6;
+	printf("  %-16s %10.2f %10.2f %10.2f %10.2f   (%lld)\n", name, n / t_insert, n / t_hit, n / t_miss, n / t_erase,
+	       sink % 10);
+}
+
+template<class Key, class Hash>
+void suite (const char *title, int n) {
+	std::vector<Key> keys, missing;
+	for (int i = 0; i < n; i++) {
+		keys.push_back(make_key(2 * i, (Key *) nullptr));
+		missing.push_back(make_key(2 * i + 1, (Key *) nullptr));
+	}
+	// shuffle with a fixed seed so both containers see the same order
+	unsigned seed = 20190401;
+	for (int i = n - 1; i > 0; i--) {
+		seed = seed * 1103515245u + 12345u;
+		std::swap(keys[i], keys[(seed >> 8) % (i + 1)]);
+	}
+	printf("%s, n=%d (Mops/s)\n", title, n);
+	printf("  %-16s %10s %10s %10s %10s\n", "", "operator[]", "find", "count miss", "erase");
+	run<sjtu::map<Key, int>, Key>("map", keys, missing);
+	run<sjtu::unordered_map<Key, int, Hash>, Key>("unordered_map", keys, missing);
+}
+
+int main (int argc, char *argv[]) {
+	int n = argc > 1 ? atoi(argv[1]) : 200000;
+	suite<IntA, IntAHash>("IntA", n);
+	suite<std::string, std::hash<std::string>>("std::string", n);
+	// BintHash prints every key, so keep this one smaller
+	suite<Util::Bint, BintHash>("Util::Bint", n / 4);
+	return 0;
+}
@@ -0,0 +1,560 @@
+//LLRB tree without parent pointers, the color is kept in the lowest bit of the right pointer
+//iterators keep the path from the root on a small stack instead
+#ifndef SJTU_COMPACT_MAP_HPP
+#define SJTU_COMPACT_MAP_HPP
+
+// only for std::less<T>
+#include <functional>
+#include <cstddef>
+#include <cstdint>
+#include <tuple>
+#include <utility>
+#include "utility.hpp"
+#include "exceptions.hpp"
+
+namespace sjtu {
+
+    template<
+            class Key ,
+            class Value ,
+            class Compare = std::less<Key>
+    >
+    class compact_map {
+    public:
+        typedef pair<const Key , Value> value_type;
+
+        struct Entry {
+            value_type kv;
+            Entry *left;
+            // the right child, with the color kept in its lowest bit
+            uintptr_t rightcolor;
+
+            // the remaining arguments construct kv in place
+            template<class... Args>
+            explicit Entry (bool color , Args &&... args) : kv(std::forward<Args>(args)...) , left(nullptr) ,
+                                                            rightcolor(color) {}
+
+            Entry *right () const { return reinterpret_cast<Entry *>(rightcolor & ~(uintptr_t) 1); }
+
+            bool color () const { return rightcolor & 1; }
+
+            void setright (Entry *p) { rightcolor = reinterpret_cast<uintptr_t>(p) | (rightcolor & 1); }
+
+            void setcolor (bool c) { rightcolor = (rightcolor & ~(uintptr_t) 1) | c; }
+        };
+
+        /**
+         * an LLRB tree with at most 2^31 entries is never deeper than this.
+         */
+        static const int MAX_DEPTH = 64;
+
+        class const_iterator;
+
+        /**
+         * see BidirectionalIterator at CppReference for help.
+         * the iterator stores its ancestors, so unlike sjtu::map it is invalidated by insert and erase.
+         *
+         * if there is anything wrong throw invalid_iterator.
+         */
+        class iterator {
+            friend class compact_map;
+
+        private:
+            compact_map *Map;
+            // the bulk of the iterator, 8 * MAX_DEPTH bytes, though a copy only moves the first depth of them
+            Entry *path[MAX_DEPTH];
+            int depth;
+
+            void leftmost (Entry *p) {
+                for (; p != nullptr; p = p->left) {
+                    path[depth++] = p;
+                }
+            }
+
+            void rightmost (Entry *p) {
+                for (; p != nullptr; p = p->right()) {
+                    path[depth++] = p;
+                }
+            }
+
+        public:
+            iterator () : Map(nullptr) , depth(0) {}
+
+            explicit iterator (compact_map *Map) : Map(Map) , depth(0) {}
+
+            iterator (const iterator &other) : Map(other.Map) , depth(other.depth) {
+                for (int i = 0; i < depth; i++) {
+                    path[i] = other.path[i];
+                }
+            }
+
+            iterator &operator= (const iterator &other) {
+                Map = other.Map;
+                depth = other.depth;
+                for (int i = 0; i < depth; i++) {
+                    path[i] = other.path[i];
+                }
+                return *this;
+            }
+
+            iterator operator++ (int) {
+                auto tmp = (*this);
+                this->operator++();
+                return tmp;
+            }
+
+            iterator &operator++ () {
+                if (depth == 0) {
+                    throw invalid_iterator();
+                }
+                Entry *p = path[depth - 1];
+                if (p->right() != nullptr) {
+                    leftmost(p->right());
+                    return *this;
+                }
+                // climb until we come up from a left child
+                for (depth--; depth > 0 && path[depth - 1]->right() == p; depth--) {
+                    p = path[depth - 1];
+                }
+                return *this;
+            }
+
+            iterator operator-- (int) {
+                auto tmp = (*this);
+                this->operator--();
+                return tmp;
+            }
+
+            iterator &operator-- () {
+                if (Map == nullptr) {
+                    throw invalid_iterator();
+                }
+                if (depth == 0) {
+                    if (Map->root == nullptr) {
+                        throw invalid_iterator();
+                    }
+                    rightmost(Map->root);
+                    return *this;
+                }
+                Entry *p = path[depth - 1];
+                if (p->left != nullptr) {
+                    path[depth++] = p->left;
+                    rightmost(p->left->right());
+                    return *this;
+                }
+                int d = depth - 1;
+                for (; d > 0 && path[d - 1]->left == p; d--) {
+                    p = path[d - 1];
+                }
+                if (d == 0) {
+                    // p was the first element
+                    throw invalid_iterator();
+                }
+                depth = d;
+                return *this;
+            }
+
+            value_type &operator* () const {
+                if (depth == 0) {
+                    throw invalid_iterator();
+                }
+                return path[depth - 1]->kv;
+            }
+
+            value_type *operator-> () const { return &operator*(); }
+
+            /**
+             * a operator to check whether two iterators are same (pointing to the same memory).
+             */
+            bool operator== (const iterator &rhs) const {
+                if (Map != rhs.Map || depth != rhs.depth) {
+                    return false;
+                }
+                return depth == 0 || path[depth - 1] == rhs.path[depth - 1];
+            }
+
+            bool operator!= (const iterator &rhs) const { return !((*this) == rhs); }
+
+            friend class const_iterator;
+        };
+
+        class const_iterator : public iterator {
+        public:
+            const_iterator () : iterator() {}
+
+            const_iterator (const const_iterator &other) : iterator(other) {}
+
+            const_iterator (const iterator &other) : iterator(other) {}
+        };
+
+    private:
+        static const bool BLACK = false;
+        static const bool RED = true;
+
+        int length = 0;
+        Entry *root = nullptr;
+
+        Entry *copytree (Entry *other) {
+            if (other == nullptr) {
+                return nullptr;
+            }
+            Entry *tmp = new Entry(other->color() , other->kv);
+            tmp->left = copytree(other->left);
+            tmp->setright(copytree(other->right()));
+            return tmp;
+        }
+
+        void cleartree (Entry *&p) {
+            if (p != nullptr) {
+                cleartree(p->left);
+                Entry *r = p->right();
+                cleartree(r);
+                delete p;
+            }
+            p = nullptr;
+        }
+
+        Entry *lookup (const Key &key) const {
+            Compare comp = Compare();
+            Entry *p = root;
+            while (p != nullptr) {
+                if (comp(p->kv.first , key)) {
+                    p = p->right();
+                } else if (comp(key , p->kv.first)) {
+                    p = p->left;
+                } else {
+                    return p;
+                }
+            }
+            return nullptr;
+        }
+
+    public:
+        compact_map () {}
+
+        compact_map (const compact_map &other) {
+            root = copytree(other.root);
+            length = other.length;
+        }
+
+        compact_map &operator= (const compact_map &other) {
+            if (this == &other) {
+                return *this;
+            }
+            cleartree(root);
+            root = copytree(other.root);
+            length = other.length;
+            return *this;
+        }
+
+        ~compact_map () {
+            cleartree(root);
+        }
+
+        /**
+         * If no such element exists, an exception of type `index_out_of_bound'
+         */
+        Value &at (const Key &key) {
+            Entry *p = lookup(key);
+            if (p == nullptr) {
+                throw index_out_of_bound();
+            }
+            return p->kv.second;
+        }
+
+        const Value &at (const Key &key) const {
+            Entry *p = lookup(key);
+            if (p == nullptr) {
+                throw index_out_of_bound();
+            }
+            return p->kv.second;
+        }
+
+        /**
+         * performing an insertion if such key does not already exist.
+         */
+        Value &operator[] (const Key &key) {
+            Entry *p = lookup(key);
+            if (p != nullptr) {
+                return p->kv.second;
+            }
+            int len = 0;
+            insert(key , p , nullptr , len , std::piecewise_construct , std::forward_as_tuple(key) , std::tuple<>());
+            return p->kv.second;
+        }
+
+        const Value &operator[] (const Key &key) const {
+            return at(key);
+        }
+
+        iterator begin () {
+            iterator it(this);
+            it.leftmost(root);
+            return it;
+        }
+
+        const_iterator cbegin () const {
+            return const_cast<compact_map *>(this)->begin();
+        }
+
+        iterator end () {
+            return iterator(this);
+        }
+
+        const_iterator cend () const {
+            return iterator(const_cast<compact_map *>(this));
+        }
+
+        bool empty () const {
+            return root == nullptr;
+        }
+
+        size_t size () const {
+            return length;
+        }
+
+        void clear () {
+            cleartree(root);
+            length = 0;
+        }
+
+        /**
+         * insert an element.
+         * return a pair, the first of the pair is
+         *   the iterator to the new element (or the element that prevented the insertion),
+         *   the second one is true if insert successfully, or false.
+         */
+        pair<iterator , bool> insert (const value_type &keyval) {
+            Entry *p;
+            Entry *trail[MAX_DEPTH];
+            int len = 0;
+            bool inserted = insert(keyval.first , p , trail , len , keyval);
+            pair<iterator , bool> result(iterator(this) , inserted);
+            for (iterator &it = result.first; len > 0; it.depth++) {
+                it.path[it.depth] = trail[--len];
+            }
+            return result;
+        }
+
+        /**
+         * erase the element at pos.
+         *
+         * throw if pos pointed to a bad element (pos == this->end() || pos points an element out of this)
+         */
+        void erase (iterator pos) {
+            if (pos.Map != this || pos.depth == 0) {
+                throw invalid_iterator();
+            }
+            if (!isred(root->left) && !isred(root->right())) {
+                root->setcolor(RED);
+            }
+            root = erase(root , pos->first);
+            length--;
+            if (root != nullptr) {
+                root->setcolor(BLACK);
+            }
+        }
+
+        size_t count (const Key &key) const {
+            return lookup(key) == nullptr ? 0 : 1;
+        }
+
+        /**
+         * If no such element is found, past-the-end (see end()) iterator is returned.
+         */
+        iterator find (const Key &key) {
+            Compare comp = Compare();
+            iterator it(this);
+            for (Entry *p = root; p != nullptr;) {
+                it.path[it.depth++] = p;
+                if (comp(p->kv.first , key)) {
+                    p = p->right();
+                } else if (comp(key , p->kv.first)) {
+                    p = p->left;
+                } else {
+                    return it;
+                }
+            }
+            return end();
+        }
+
+        const_iterator find (const Key &key) const {
+            return const_cast<compact_map *>(this)->find(key);
+        }
+
+    private:
+        static bool isred (Entry *p) {
+            return p != nullptr && p->color() == RED;
+        }
+
+        // one walk down and back up: result is the entry with key, new or not, and if trail is not
+        // null it gets the path to result from the root, bottom up. return true if result is new
+        template<class... Args>
+        bool insert (const Key &key , Entry *&result , Entry **trail , int &len , Args &&... args) {
+            bool inserted = false;
+            root = insert(root , key , result , inserted , trail , len , std::forward<Args>(args)...);
+            root->setcolor(BLACK);
+            length += inserted;
+            return inserted;
+        }
+
+        // args construct the new entry's kv, they are left alone if key is already there
+        template<class... Args>
+        Entry *insert (Entry *p , const Key &key , Entry *&result , bool &inserted , Entry **trail , int &len ,
+                       Args &&... args) {
+            Compare comp = Compare();
+            if (p == nullptr || !(comp(p->kv.first , key) || comp(key , p->kv.first))) {
+                if (p == nullptr) {
+                    p = new Entry(RED , std::forward<Args>(args)...);
+                    inserted = true;
+                }
+                result = p;
+                if (trail != nullptr) {
+                    trail[0] = p;
+                    len = 1;
+                }
+                return p;
+            }
+            if (comp(p->kv.first , key)) {
+                p->setright(insert(p->right() , key , result , inserted , trail , len , std::forward<Args>(args)...));
+            } else {
+                p->left = insert(p->left , key , result , inserted , trail , len , std::forward<Args>(args)...);
+            }
+            // an existing key changed nothing, and a fixup that keeps p on top only changed colors
+            Entry *r = inserted ? fixup(p) : p;
+            if (trail != nullptr) {
+                if (r == p) {
+                    trail[len++] = p;
+                } else {
+                    retrace(r , key , trail , len);
+                }
+            }
+            return r;
+        }
+
+        // trail leads bottom up from result to a child of the subtree p was just fixed up into.
+        // the rotations only rearranged the top of that subtree, so everything two levels down
+        // is still in place and the rest of the path is found again from p in a few steps
+        static void retrace (Entry *p , const Key &key , Entry **trail , int &len) {
+            Compare comp = Compare();
+            if (len > 1) {
+                len--;
+            }
+            Entry *above[4];
+            int n = 0;
+            for (; p != trail[len - 1]; p = comp(p->kv.first , key) ? p->right() : p->left) {
+                above[n++] = p;
+            }
+            while (n > 0) {
+                trail[len++] = above[--n];
+            }
+        }
+
+        Entry *fixup (Entry *p) {
+            if (isred(p->right())) {
+                p = rotateleft(p);
+            }
+            if (isred(p->left) && isred(p->left->left)) {
+                p = rotateright(p);
+            }
+            if (isred(p->left) && isred(p->right())) {
+                colorflip(p);
+            }
+            return p;
+        }
+
+        Entry *moveredleft (Entry *p) {
+            colorflip(p);
+            if (p->right() != nullptr && isred(p->right()->left)) {
+                p->setright(rotateright(p->right()));
+                p = rotateleft(p);
+                colorflip(p);
+            }
+            return p;
+        }
+
+        Entry *moveredright (Entry *p) {
+            colorflip(p);
+            if (p->left != nullptr && isred(p->left->left)) {
+                p = rotateright(p);
+                colorflip(p);
+            }
+            return p;
+        }
+
+        Entry *deleteMin (Entry *p , Entry *&deleted) {
+            if (p->left == nullptr) {
+                deleted = p;
+                return p->right();
+            }
+            if (!isred(p->left) && !isred(p->left->left) && p->right() != nullptr) {
+                p = moveredleft(p);
+            }
+            p->left = deleteMin(p->left , deleted);
+            return fixup(p);
+        }
+
+        Entry *erase (Entry *p , const Key &key) {
+            Compare comp = Compare();
+            if (comp(key , p->kv.first)) {
+                if (p->left != nullptr && !isred(p->left) && !isred(p->left->left)) {
+                    p = moveredleft(p);
+                }
+                p->left = erase(p->left , key);
+            } else {
+                if (isred(p->left)) {
+                    p = rotateright(p);
+                }
+                if (!comp(key , p->kv.first) && !comp(p->kv.first , key) && p->right() == nullptr) {
+                    delete p;
+                    return nullptr;
+                }
+                if (!isred(p->right()) && !isred(p->right()->left)) {
+                    p = moveredright(p);
+                }
+                if (!comp(key , p->kv.first) && !comp(p->kv.first , key)) {
+                    // relink the successor in place of p, entries are never assigned
+                    Entry *deleted;
+                    Entry *right = deleteMin(p->right() , deleted);
+                    deleted->left = p->left;
+                    deleted->rightcolor = p->rightcolor;
+                    deleted->setright(right);
+                    delete p;
+                    p = deleted;
+                } else {
+                    p->setright(erase(p->right() , key));
+                }
+            }
+            return fixup(p);
+        }
+
+        void colorflip (Entry *p) {
+            p->left->setcolor(!p->left->color());
+            p->setcolor(!p->color());
+            p->right()->setcolor(!p->right()->color());
+        }
+
+        Entry *rotateleft (Entry *p) {
+            Entry *tmp = p->right();
+            p->setright(tmp->left);
+            tmp->left = p;
+            bool color = p->color();
+            p->setcolor(tmp->color());
+            tmp->setcolor(color);
+            return tmp;
+        }
+
+        Entry *rotateright (Entry *p) {
+            Entry *tmp = p->left;
+            p->left = tmp->right();
+            tmp->setright(p);
+            bool color = p->color();
+            p->setcolor(tmp->color());
+            tmp->setcolor(color);
+            return tmp;
+        }
+    };
+
+}
+
+#endif
@@ -0,0 +1,478 @@
+//a concurrent LLRB tree with RCU style reads
+//writers are serialized by a mutex and publish a path-copied tree,
+//readers never lock and never see a node change under them
+#ifndef SJTU_CONCURRENT_MAP_HPP
+#define SJTU_CONCURRENT_MAP_HPP
+
+// only for std::less<T>
+#include <functional>
+#include <cstddef>
+#include <atomic>
+#include <mutex>
+#include <vector>
+#include "utility.hpp"
+#include "exceptions.hpp"
+#include "epoch.hpp"
+
+namespace sjtu {
+
+    template<
+            class Key ,
+            class Value ,
+            class Compare = std::less<Key>
+    >
+    class concurrent_map {
+    public:
+        typedef pair<const Key , Value> value_type;
+
+    private:
+        static const bool BLACK = false;
+        static const bool RED = true;
+
+        /**
+         * a node is immutable once it is reachable from the published root.
+         * stamp is the write that created it: only nodes of the current write may be changed in place.
+         */
+        struct Entry {
+            value_type kv;
+            Entry *left;
+            Entry *right;
+            bool color;
+            unsigned long stamp;
+
+            Entry (const value_type &kv , bool color , unsigned long stamp) : kv(kv) , left(nullptr) , right(nullptr) ,
+                                                                                color(color) , stamp(stamp) {}
+
+            Entry (const Entry &other , unsigned long stamp) : kv(other.kv) , left(other.left) , right(other.right) ,
+                                                                color(other.color) , stamp(stamp) {}
+        };
+
+        std::atomic<Entry *> root;
+        std::atomic<size_t> length;
+        std::mutex writer;
+        mutable epoch_domain domain;
+        unsigned long stamp = 0;
+
+    public:
+        /**
+         * a consistent read-only view of the map.
+         * it pins the epoch, so keep it short lived: writers cannot free memory while it exists.
+         */
+        class snapshot {
+            friend class concurrent_map;
+
+        private:
+            epoch_domain::guard pin;
+            Entry *root;
+
+            explicit snapshot (const concurrent_map *Map) : pin(Map->domain.pin()) ,
+                                                             root(Map->root.load(std::memory_order_acquire)) {}
+
+        public:
+            /**
+             * forward iterator in key order.
+             * there are no parent pointers, so it keeps the path from the root on a stack.
+             */
+            class const_iterator {
+                friend class snapshot;
+
+            private:
+                std::vector<Entry *> path;
+
+                void descend (Entry *p) {
+                    while (p != nullptr) {
+                        path.push_back(p);
+                        p = p->left;
+                    }
+                }
+
+            public:
+                const_iterator () {}
+
+                const_iterator operator++ (int) {
+                    auto tmp = *this;
+                    operator++();
+                    return tmp;
+                }
+
+                const_iterator &operator++ () {
+                    if (path.empty()) {
+                        throw invalid_iterator();
+                    }
+                    auto p = path.back();
+                    path.pop_back();
+                    descend(p->right);
+                    return *this;
+                }
+
+                const value_type &operator* () const {
+                    if (path.empty()) {
+                        throw invalid_iterator();
+                    }
+                    return path.back()->kv;
+                }
+
+                const value_type *operator-> () const {
+                    return &operator*();
+                }
+
+                bool operator== (const const_iterator &rhs) const {
+                    if (path.empty() || rhs.path.empty()) {
+                        return path.empty() && rhs.path.empty();
+                    }
+                    return path.back() == rhs.path.back();
+                }
+
+                bool operator!= (const const_iterator &rhs) const { return !((*this) == rhs); }
+            };
+
+            const_iterator begin () const {
+                const_iterator it;
+                it.descend(root);
+                return it;
+            }
+
+            const_iterator end () const {
+                return const_iterator();
+            }
+
+            size_t count (const Key &key) const {
+                return concurrent_map::lookup(root , key) == nullptr ? 0 : 1;
+            }
+
+            const Value &at (const Key &key) const {
+                auto p = concurrent_map::lookup(root , key);
+                if (p == nullptr) {
+                    throw index_out_of_bound();
+                }
+                return p->kv.second;
+            }
+        };
+
+        concurrent_map () : root(nullptr) , length(0) {}
+
+        concurrent_map (const concurrent_map &other) = delete;
+
+        concurrent_map &operator= (const concurrent_map &other) = delete;
+
+        ~concurrent_map () {
+            cleartree(root.load());
+        }
+
+        /**
+         * returns the number of elements at some recent point in time.
+         */
+        size_t size () const {
+            return length.load(std::memory_order_acquire);
+        }
+
+        bool empty () const {
+            return size() == 0;
+        }
+
+        snapshot snap () const {
+            return snapshot(this);
+        }
+
+        /**
+         * lock free lookups. values are returned by copy because the entry
+         * may be replaced as soon as the reader leaves its critical section.
+         */
+        size_t count (const Key &key) const {
+            auto pin = domain.pin();
+            return lookup(root.load(std::memory_order_acquire) , key) == nullptr ? 0 : 1;
+        }
+
+        bool find (const Key &key , Value &result) const {
+            auto pin = domain.pin();
+            auto p = lookup(root.load(std::memory_order_acquire) , key);
+            if (p == nullptr) {
+                return false;
+            }
+            result = p->kv.second;
+            return true;
+        }
+
+        /**
+         * throw index_out_of_bound if such key does not exist.
+         */
+        Value at (const Key &key) const {
+            auto pin = domain.pin();
+            auto p = lookup(root.load(std::memory_order_acquire) , key);
+            if (p == nullptr) {
+                throw index_out_of_bound();
+            }
+            return p->kv.second;
+        }
+
+        /**
+         * insert an element, return false if the key already exists.
+         */
+        bool insert (const value_type &keyval) {
+            std::lock_guard<std::mutex> lock(writer);
+            Entry *r = root.load(std::memory_order_relaxed);
+            if (lookup(r , keyval.first) != nullptr) {
+                return false;
+            }
+            stamp++;
+            r = insert(r , keyval , false);
+            publish(r);
+            length.fetch_add(1 , std::memory_order_release);
+            domain.collect();
+            return true;
+        }
+
+        /**
+         * insert an element or replace the value of an existing one.
+         * return true if a new element is inserted.
+         */
+        bool assign (const value_type &keyval) {
+            std::lock_guard<std::mutex> lock(writer);
+            Entry *r = root.load(std::memory_order_relaxed);
+            bool exist = lookup(r , keyval.first) != nullptr;
+            stamp++;
+            r = insert(r , keyval , true);
+            publish(r);
+            if (!exist) {
+                length.fetch_add(1 , std::memory_order_release);
+            }
+            domain.collect();
+            return !exist;
+        }
+
+        /**
+         * erase the element with key, return the number of erased elements (0 or 1).
+         */
+        size_t erase (const Key &key) {
+            std::lock_guard<std::mutex> lock(writer);
+            Entry *r = root.load(std::memory_order_relaxed);
+            if (lookup(r , key) == nullptr) {
+                return 0;
+            }
+            stamp++;
+            // erase(Entry *, const Key &) rewrites its argument, the published root included
+            r = own(r);
+            if (!isred(r->left) && !isred(r->right)) {
+                r->color = RED;
+            }
+            r = erase(r , key);
+            publish(r);
+            length.fetch_sub(1 , std::memory_order_release);
+            domain.collect();
+            return 1;
+        }
+
+        void clear () {
+            std::lock_guard<std::mutex> lock(writer);
+            Entry *r = root.load(std::memory_order_relaxed);
+            root.store(nullptr , std::memory_order_release);
+            length.store(0 , std::memory_order_release);
+            retiretree(r);
+            domain.reclaim();
+        }
+
+        /**
+         * number of retired entries waiting for readers to move on.
+         */
+        size_t pending () {
+            std::lock_guard<std::mutex> lock(writer);
+            domain.reclaim();
+            return domain.pending();
+        }
+
+    private:
+        static Entry *lookup (Entry *p , const Key &key) {
+            Compare comp = Compare();
+            while (p != nullptr) {
+                if (comp(p->kv.first , key)) {
+                    p = p->right;
+                } else if (comp(key , p->kv.first)) {
+                    p = p->left;
+                } else {
+                    return p;
+                }
+            }
+            return nullptr;
+        }
+
+        void publish (Entry *r) {
+            if (r != nullptr && r->color == RED) {
+                r = own(r);
+                r->color = BLACK;
+            }
+            root.store(r , std::memory_order_release);
+        }
+
+        static void cleartree (Entry *p) {
+            if (p != nullptr) {
+                cleartree(p->left);
+                cleartree(p->right);
+                delete p;
+            }
+        }
+
+        void retiretree (Entry *p) {
+            if (p != nullptr) {
+                retiretree(p->left);
+                retiretree(p->right);
+                domain.retire(p);
+            }
+        }
+
+        // a writable copy of p for the current write; the shared original is retired
+        Entry *own (Entry *p) {
+            if (p->stamp == stamp) {
+                return p;
+            }
+            auto tmp = new Entry(*p , stamp);
+            domain.retire(p);
+            return tmp;
+        }
+
+        // drop an entry that has been unlinked by the current write
+        void release (Entry *p) {
+            if (p->stamp == stamp) {
+                delete p;
+            } else {
+                domain.retire(p);
+            }
+        }
+
+        static bool isred (Entry *p) {
+            return p != nullptr && p->color == RED;
+        }
+
+        Entry *insert (Entry *p , const value_type &keyval , bool replace) {
+            Compare comp = Compare();
+            if (p == nullptr) {
+                return new Entry(keyval , RED , stamp);
+            }
+            if (comp(p->kv.first , keyval.first)) {
+                p = own(p);
+                p->right = insert(p->right , keyval , replace);
+            } else if (comp(keyval.first , p->kv.first)) {
+                p = own(p);
+                p->left = insert(p->left , keyval , replace);
+            } else {
+                // only reached with replace: values cannot be assigned in place, so a new entry takes over
+                auto tmp = new Entry(keyval , p->color , stamp);
+                tmp->left = p->left;
+                tmp->right = p->right;
+                release(p);
+                p = tmp;
+            }
+            return fixup(p);
+        }
+
+        // p must be owned by the current write
+        Entry *fixup (Entry *p) {
+            if (isred(p->right)) {
+                p = rotateleft(p);
+            }
+            if (isred(p->left) && isred(p->left->left)) {
+                p = rotateright(p);
+            }
+            if (isred(p->left) && isred(p->right)) {
+                colorflip(p);
+            }
+            return p;
+        }
+
+        Entry *moveredleft (Entry *p) {
+            colorflip(p);
+            if (p->right != nullptr && isred(p->right->left)) {
+                p->right = rotateright(own(p->right));
+                p = rotateleft(p);
+                colorflip(p);
+            }
+            return p;
+        }
+
+        Entry *moveredright (Entry *p) {
+            colorflip(p);
+            if (p->left != nullptr && isred(p->left->left)) {
+                p = rotateright(p);
+                colorflip(p);
+            }
+            return p;
+        }
+
+        // unlink the minimum of the subtree into deleted, without freeing it
+        Entry *deleteMin (Entry *p , Entry *&deleted) {
+            if (p->left == nullptr) {
+                deleted = p;
+                return p->right;
+            }
+            p = own(p);
+            if (!isred(p->left) && !isred(p->left->left) && p->right != nullptr) {
+                p = moveredleft(p);
+            }
+            p->left = deleteMin(p->left , deleted);
+            return fixup(p);
+        }
+
+        // p must be owned by the current write, key must exist in the subtree
+        Entry *erase (Entry *p , const Key &key) {
+            Compare comp = Compare();
+            if (comp(key , p->kv.first)) {
+                if (p->left != nullptr && !isred(p->left) && !isred(p->left->left)) {
+                    p = moveredleft(p);
+                }
+                p->left = erase(own(p->left) , key);
+            } else {
+                if (isred(p->left)) {
+                    p = rotateright(p);
+                }
+                if (!comp(key , p->kv.first) && !comp(p->kv.first , key) && p->right == nullptr) {
+                    release(p);
+                    return nullptr;
+                }
+                if (!isred(p->right) && !isred(p->right->left)) {
+                    p = moveredright(p);
+                }
+                if (!comp(key , p->kv.first) && !comp(p->kv.first , key)) {
+                    Entry *deleted;
+                    auto right = deleteMin(p->right , deleted);
+                    // the successor takes the place of p
+                    deleted = own(deleted);
+                    deleted->left = p->left;
+                    deleted->right = right;
+                    deleted->color = p->color;
+                    release(p);
+                    p = deleted;
+                } else {
+                    p->right = erase(own(p->right) , key);
+                }
+            }
+            return fixup(p);
+        }
+
+        // p must be owned by the current write, its children are copied as needed
+        void colorflip (Entry *p) {
+            p->left = own(p->left);
+            p->right = own(p->right);
+            p->left->color = !p->left->color;
+            p->color = !p->color;
+            p->right->color = !p->right->color;
+        }
+
+        Entry *rotateleft (Entry *p) {
+            auto tmp = own(p->right);
+            p->right = tmp->left;
+            tmp->left = p;
+            std::swap(p->color , tmp->color);
+            return tmp;
+        }
+
+        Entry *rotateright (Entry *p) {
+            auto tmp = own(p->left);
+            p->left = tmp->right;
+            tmp->right = p;
+            std::swap(p->color , tmp->color);
+            return tmp;
+        }
+    };
+
+}
+
+#endif
@@ -5,28 +5,35 @@
 #include <iomanip>
 #include <vector>
 #include <stdexcept>
+#include <algorithm>
+#include <cstring>
+#include <memory>
+#include <thread>
 
 namespace Diamond {
 
+/**
+ * a dense matrix, its elements in one row-major buffer.
+ */
 template<typename _Td>
 class Matrix {
 protected:
 	size_t n_rows = 0;
 	size_t n_cols = 0;
-	std::vector<std::vector<_Td>> data;
+	std::vector<_Td> data;
 	class RowProxy {
-		std::vector<_Td> &row;
+		_Td *row;
 	public:
-		RowProxy(std::vector<_Td> & _row) : row(_row) {}
+		RowProxy(_Td *_row) : row(_row) {}
 		_Td & operator[](const size_t &pos)
 		{
 			return row[pos];
 		}
 	};
 	class ConstRowProxy {
-		const std::vector<_Td> &row;
+		const _Td *row;
 	public:
-		ConstRowProxy(const std::vector<_Td> &_row) : row(_row) {}
+		ConstRowProxy(const _Td *_row) : row(_row) {}
 		const _Td & operator[](const size_t &pos) const
 		{
 			return row[pos];
@@ -35,13 +42,16 @@ protected:
 public:
 	Matrix() {};
 	Matrix(const size_t &_n_rows, const size_t &_n_cols)
-		: n_rows(_n_rows), n_cols(_n_cols), data(std::vector<std::vector<_Td>>(n_rows, std::vector<_Td>(n_cols))) {}
+		: n_rows(_n_rows), n_cols(_n_cols), data(n_rows * n_cols) {}
 	Matrix(const size_t &_n_rows, const size_t &_n_cols, const _Td &fillValue)
-		: n_rows(_n_rows), n_cols(_n_cols), data(std::vector<std::vector<_Td>>(n_rows, std::vector<_Td>(n_cols, fillValue))) {}
+		: n_rows(_n_rows), n_cols(_n_cols), data(n_rows * n_cols, fillValue) {}
 	Matrix(const Matrix<_Td> &mat)
 		: n_rows(mat.n_rows), n_cols(mat.n_cols), data(mat.data) {}
 	Matrix(Matrix<_Td> &&mat) noexcept
-		: n_rows(mat.n_rows), n_cols(mat.n_cols), data(mat.data) {}
+		: n_rows(mat.n_rows), n_cols(mat.n_cols), data(std::move(mat.data))
+	{
+		mat.n_rows = mat.n_cols = 0;
+	}
 	Matrix<_Td> & operator=(const Matrix<_Td> &rhs)
 	{
 		this->n_rows = rhs.n_rows;
@@ -51,9 +61,12 @@ public:
 	}
 	Matrix<_Td> & operator=(Matrix<_Td> &&rhs)
 	{
-		this->n_rows = rhs.n_rows;
-		this->n_cols = rhs.n_cols;
-		this->data = rhs.data;
+		if (this != &rhs) {
+			this->n_rows = rhs.n_rows;
+			this->n_cols = rhs.n_cols;
+			this->data = std::move(rhs.data);
+			rhs.n_rows = rhs.n_cols = 0;
+		}
 		return *this;
 	}
 	inline const size_t & RowSize() const
@@ -64,13 +77,24 @@ public:
 	{
 		return n_cols;
 	}
+	/**
+	 * the element (i, j) is Data()[i * ColSize() + j].
+	 */
+	inline _Td * Data()
+	{
+		return data.data();
+	}
+	inline const _Td * Data() const
+	{
+		return data.data();
+	}
 	RowProxy operator[](const size_t &Kth)
 	{
-		return RowProxy(this->data[Kth]);
+		return RowProxy(this->data.data() + Kth * n_cols);
 	}
 	const ConstRowProxy operator[](const size_t &Kth) const
 	{
-		return ConstRowProxy(this->data[Kth]);
+		return ConstRowProxy(this->data.data() + Kth * n_cols);
 	}
 	~Matrix() = default;
 };
@@ -145,6 +169,201 @@ Matrix<_Td> operator-(Matrix<_Td> &&mat)
 	return mat;
 }
 
+// a block of MATRIX_KC rows by MATRIX_NC columns of b stays in cache while every row of a passes over it,
+// measured with benchmark/matrix
+const size_t MATRIX_KC = 256;
+const size_t MATRIX_NC = 512;
+// products with fewer multiply-adds than this skip the packing: a matrix that small is usually a container
+// payload, and from 8 x 8 on the packed kernel is already ahead, measured with benchmark/matrix
+const size_t MATRIX_SMALL = 8 * 8 * 8;
+
+/**
+ * c[rowBegin, rowEnd) += a * b on row-major buffers, a is m columns wide and b and c are p.
+ * i-k-j order walks b and c along their rows, and every c[i][j] still adds its products
+ * in increasing k, so the result is the one the i-j-k loop gives.
+ */
+template<typename _Td>
+void MultiplyScalar(const _Td *a, const _Td *b, _Td *c, size_t m, size_t p, size_t rowBegin, size_t rowEnd)
+{
+	for (size_t jj = 0; jj < p; jj += MATRIX_NC) {
+		size_t je = std::min(p, jj + MATRIX_NC);
+		for (size_t kk = 0; kk < m; kk += MATRIX_KC) {
+			size_t ke = std::min(m, kk + MATRIX_KC);
+			for (size_t i = rowBegin; i < rowEnd; ++i) {
+				_Td *ci = c + i * p;
+				for (size_t k = kk; k < ke; ++k) {
+					const _Td aik = a[i * m + k];
+					const _Td *bk = b + k * p;
+					for (size_t j = jj; j < je; ++j) {
+						ci[j] += aik * bk[j];
+					}
+				}
+			}
+		}
+	}
+}
+
+template<typename _Td>
+struct MultiplyKernel {
+	static void Run(const _Td *a, const _Td *b, _Td *c, size_t m, size_t p, size_t rowBegin, size_t rowEnd)
+	{
+		MultiplyScalar(a, b, c, m, p, rowBegin, rowEnd);
+	}
+};
+
+#if defined(__GNUC__)
+#if defined(__AVX512F__)
+const size_t MATRIX_SIMD_BYTES = 64;
+#elif defined(__AVX__)
+const size_t MATRIX_SIMD_BYTES = 32;
+#else
+const size_t MATRIX_SIMD_BYTES = 16;
+#endif
+
+/**
+ * the float and double kernel: the block of b is packed into panels two vectors wide, and a 4 x 2
+ * vector tile of c is kept in registers while k runs through the block. columns that do not fill
+ * a panel, the last rows that do not fill a tile and products below MATRIX_SMALL go through the scalar loop.
+ */
+template<typename _Td>
+struct SimdMultiplyKernel {
+	typedef _Td Vector __attribute__((vector_size(MATRIX_SIMD_BYTES)));
+	static const size_t W = MATRIX_SIMD_BYTES / sizeof(_Td);
+
+	static Vector Load(const _Td *p)
+	{
+		Vector v;
+		memcpy(&v, p, sizeof(v));
+		return v;
+	}
+
+	static void Store(_Td *p, const Vector &v)
+	{
+		memcpy(p, &v, sizeof(v));
+	}
+
+	// room for at least size elements, one buffer per thread that only grows and is never initialized
+	static _Td *Panel(size_t size)
+	{
+		static thread_local std::unique_ptr<_Td[]> buffer;
+		static thread_local size_t capacity = 0;
+		if (capacity < size) {
+			buffer.reset(new _Td[size]);
+			capacity = size;
+		}
+		return buffer.get();
+	}
+
+	static void Run(const _Td *a, const _Td *b, _Td *c, size_t m, size_t p, size_t rowBegin, size_t rowEnd)
+	{
+		size_t width = std::min(p, MATRIX_NC) / (2 * W) * (2 * W);
+		if ((rowEnd - rowBegin) * m * p < MATRIX_SMALL || width == 0 || rowEnd - rowBegin < 4) {
+			MultiplyScalar(a, b, c, m, p, rowBegin, rowEnd);
+			return;
+		}
+		_Td *panel = Panel(std::min(m, MATRIX_KC) * width);
+		for (size_t jj = 0; jj < p; jj += MATRIX_NC) {
+			size_t je = std::min(p, jj + MATRIX_NC);
+			// columns [jj, jv) are covered by whole panels
+			size_t jv = jj + (je - jj) / (2 * W) * (2 * W);
+			for (size_t kk = 0; kk < m; kk += MATRIX_KC) {
+				size_t ke = std::min(m, kk + MATRIX_KC), kc = ke - kk;
+				for (size_t j = jj; j < jv; j += 2 * W) {
+					_Td *dest = panel + (j - jj) * kc;
+					for (size_t k = kk; k < ke; ++k, dest += 2 * W) {
+						memcpy(dest, b + k * p + j, sizeof(_Td) * 2 * W);
+					}
+				}
+				size_t i = rowBegin;
+				for (; i + 4 <= rowEnd; i += 4) {
+					const _Td *a0 = a + i * m, *a1 = a0 + m, *a2 = a1 + m, *a3 = a2 + m;
+					_Td *c0 = c + i * p, *c1 = c0 + p, *c2 = c1 + p, *c3 = c2 + p;
+					for (size_t j = jj; j < jv; j += 2 * W) {
+						const _Td *source = panel + (j - jj) * kc;
+						Vector t00 = Load(c0 + j), t01 = Load(c0 + j + W);
+						Vector t10 = Load(c1 + j), t11 = Load(c1 + j + W);
+						Vector t20 = Load(c2 + j), t21 = Load(c2 + j + W);
+						Vector t30 = Load(c3 + j), t31 = Load(c3 + j + W);
+						for (size_t k = kk; k < ke; ++k, source += 2 * W) {
+							Vector b0 = Load(source), b1 = Load(source + W);
+							t00 += b0 * a0[k];
+							t01 += b1 * a0[k];
+							t10 += b0 * a1[k];
+							t11 += b1 * a1[k];
+							t20 += b0 * a2[k];
+							t21 += b1 * a2[k];
+							t30 += b0 * a3[k];
+							t31 += b1 * a3[k];
+						}
+						Store(c0 + j, t00);
+						Store(c0 + j + W, t01);
+						Store(c1 + j, t10);
+						Store(c1 + j + W, t11);
+						Store(c2 + j, t20);
+						Store(c2 + j + W, t21);
+						Store(c3 + j, t30);
+						Store(c3 + j + W, t31);
+					}
+					for (size_t r = i; r < i + 4; ++r) {
+						Edge(a, b, c, m, p, r, jv, je, kk, ke);
+					}
+				}
+				for (; i < rowEnd; ++i) {
+					Edge(a, b, c, m, p, i, jj, je, kk, ke);
+				}
+			}
+		}
+	}
+
+	static void Edge(const _Td *a, const _Td *b, _Td *c, size_t m, size_t p, size_t i, size_t jb, size_t je,
+	                 size_t kk, size_t ke)
+	{
+		_Td *ci = c + i * p;
+		for (size_t k = kk; k < ke; ++k) {
+			const _Td aik = a[i * m + k];
+			const _Td *bk = b + k * p;
+			for (size_t j = jb; j < je; ++j) {
+				ci[j] += aik * bk[j];
+			}
+		}
+	}
+};
+
+template<>
+struct MultiplyKernel<float> : SimdMultiplyKernel<float> {};
+
+template<>
+struct MultiplyKernel<double> : SimdMultiplyKernel<double> {};
+#endif
+
+/**
+ * a * b with its rows shared out among up to `threads` threads; the result does not depend on the count.
+ */
+template<typename _Td>
+Matrix<_Td> Multiply(const Matrix<_Td> &a, const Matrix<_Td> &b, size_t threads)
+{
+	if (a.ColSize() != b.RowSize()) {
+		throw std::invalid_argument("different matrics\'s sizes");
+	}
+	Matrix<_Td> c(a.RowSize(), b.ColSize(), 0);
+	size_t n = a.RowSize(), m = a.ColSize(), p = b.ColSize();
+	// whole tiles of four rows per thread, and no thread for less than a few rows
+	threads = std::max(static_cast<size_t>(1), std::min(threads, n / 16));
+	size_t step = ((n + threads - 1) / threads + 3) / 4 * 4;
+	std::vector<std::thread> workers;
+	for (size_t begin = step; begin < n; begin += step) {
+		size_t end = std::min(n, begin + step);
+		workers.emplace_back([&a, &b, &c, m, p, begin, end] {
+			MultiplyKernel<_Td>::Run(a.Data(), b.Data(), c.Data(), m, p, begin, end);
+		});
+	}
+	MultiplyKernel<_Td>::Run(a.Data(), b.Data(), c.Data(), m, p, 0, std::min(n, step));
+	for (auto &worker : workers) {
+		worker.join();
+	}
+	return c;
+}
+
 /**
  * Multiplication of two matrics.
  */
@@ -155,13 +374,7 @@ Matrix<_Td> operator*(const Matrix<_Td> &a, const Matrix<_Td> &b)
 		throw std::invalid_argument("different matrics\'s sizes");
 	}
 	Matrix<_Td> c(a.RowSize(), b.ColSize(), 0);
-	for (size_t i = 0; i < a.RowSize(); ++i) {
-		for (size_t j = 0; j < b.ColSize(); ++j) {
-			for (size_t k = 0; k < a.ColSize(); ++k) {
-				c[i][j] += a[i][k] * b[k][j];
-			}
-		}
-	}
+	MultiplyKernel<_Td>::Run(a.Data(), b.Data(), c.Data(), a.ColSize(), b.ColSize(), 0, a.RowSize());
 	return c;
 }
 
@@ -0,0 +1,128 @@
+// concurrent_map: sequential checks against std::map, then readers racing a writer
+
+#include <iostream>
+#include <cstdio>
+#include <map>
+#include <string>
+#include <thread>
+#include <atomic>
+#include <vector>
+#include "../../concurrent_map.hpp"
+
+long long aa = 13131, bb = 5353, MOD = (long long) (1e9 + 7), now = 1;
+
+int rand () {
+	for (int i = 1; i < 3; i++)
+		now = (now * aa + bb) % MOD;
+	return now;
+}
+
+class Data {
+public:
+	int *x;
+	Data () : x(new int(1)) {}
+	Data (int p) : x(new int(p)) {}
+	Data (const Data &other) : x(new int(*(other.x))) {}
+	~Data () {
+		delete x;
+	}
+	Data &operator= (const Data &other) {
+		if (this == &other) return *this;
+		*x = *(other.x);
+		return *this;
+	}
+};
+
+void test_sequential () {
+	puts("Test: sequential");
+	sjtu::concurrent_map<int, Data> map;
+	std::map<int, int> ref;
+	bool ok = true;
+	for (int i = 0; i < 20000; i++) {
+		int op = rand() % 4, key = rand() % 3000, val = rand();
+		if (op == 0) {
+			bool a = map.insert(sjtu::pair<int, Data>(key, Data(val)));
+			bool b = ref.insert(std::make_pair(key, val)).second;
+			ok &= a == b;
+		} else if (op == 1) {
+			bool a = map.assign(sjtu::pair<int, Data>(key, Data(val)));
+			bool b = ref.count(key) == 0;
+			ref[key] = val;
+			ok &= a == b;
+		} else if (op == 2) {
+			ok &= map.erase(key) == ref.erase(key);
+		} else {
+			Data d;
+			bool a = map.find(key, d);
+			ok &= a == (ref.count(key) == 1);
+			if (a) ok &= *d.x == ref[key];
+		}
+	}
+	ok &= map.size() == ref.size();
+	{
+		auto snap = map.snap();
+		auto it = snap.begin();
+		for (auto jt = ref.begin(); jt != ref.end(); ++jt, ++it) {
+			ok &= it != snap.end() && it->first == jt->first && *it->second.x == jt->second;
+		}
+		ok &= it == snap.end();
+		try {
+			snap.at(-1);
+			ok = false;
+		} catch (sjtu::index_out_of_bound) {
+		}
+	}
+	std::cout << "size:" << map.size() << std::endl;
+	std::cout << (ok ? "PASSED" : "FAILED") << std::endl;
+	map.clear();
+	std::cout << "empty:" << map.empty() << " pending:" << map.pending() << std::endl;
+}
+
+void test_concurrent () {
+	puts("Test: concurrent");
+	const int N = 20000, READERS = 4;
+	sjtu::concurrent_map<int, std::string> map;
+	std::atomic<bool> done(false), bad(false);
+	std::vector<std::thread> readers;
+	for (int t = 0; t < READERS; t++) {
+		readers.emplace_back([&, t] {
+			unsigned seed = t + 1;
+			while (!done.load()) {
+				for (int i = 0; i < 1000; i++) {
+					seed = seed * 1103515245u + 12345u;
+					int key = (seed >> 8) % N;
+					std::string s;
+					if (map.find(key, s) && s != std::to_string(key)) bad = true;
+				}
+				auto snap = map.snap();
+				int last = -1;
+				for (auto it = snap.begin(); it != snap.end(); ++it) {
+					if (it->first <= last || it->second != std::to_string(it->first)) bad = true;
+					last = it->first;
+				}
+			}
+		});
+	}
+	for (int i = 0; i < N; i++) {
+		map.insert(sjtu::pair<int, std::string>(i * 7919 % N, std::to_string(i * 7919 % N)));
+	}
+	for (int i = 1; i < N; i += 2) {
+		map.erase(i);
+	}
+	for (int i = 0; i < N; i += 4) {
+		map.assign(sjtu::pair<int, std::string>(i, std::to_string(i)));
+	}
+	done = true;
+	for (auto &t : readers) t.join();
+	std::cout << "size:" << map.size() << std::endl;
+	std::cout << "count:" << map.count(N - 2) << map.count(N - 1) << std::endl;
+	std::cout << (bad ? "FAILED" : "PASSED") << std::endl;
+	map.clear();
+	std::cout << "pending:" << map.pending() << std::endl;
+}
+
+int main () {
+	test_sequential();
+	test_concurrent();
+	return 0;
+}
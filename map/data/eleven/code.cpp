@@ -0,0 +1,76 @@
+// map: the count_stats policy, entries allocated against entries freed and rebalancing work
+
+#include <iostream>
+#include <cstdio>
+#include <type_traits>
+#include <utility>
+#include "../../map.hpp"
+
+template<class M>
+void print (const char *name, const M &m) {
+	sjtu::container_stats s = m.stats();
+	unsigned long long live = s.allocations - s.deallocations;
+	// every entry has the same size, so the live bytes are live entries of it
+	unsigned long long entry = s.allocations == 0 ? 0 : s.bytes_allocated / s.allocations;
+	printf("%s: size %d live %llu bytes %d rotations %d flips %d\n", name, (int) m.size(), live,
+	       (int) (s.bytes_allocated - s.bytes_freed == live * entry), (int) (s.rotations > 0),
+	       (int) (s.color_flips > 0));
+}
+
+// memory_usage() against the bytes the counting policy saw allocated
+template<class C>
+void footprint (const char *name, const C &c) {
+	sjtu::container_stats s = c.stats();
+	sjtu::container_memory m = c.memory_usage();
+	printf("%s memory: payload %d consistent %d\n", name, (int) m.payload,
+	       (int) (s.bytes_allocated - s.bytes_freed + sizeof(C) == m.total()));
+}
+
+// the default policy is an empty base: counting adds exactly the counters, no_stats adds nothing
+static_assert(std::is_empty<sjtu::no_stats>::value, "no_stats must be an empty base");
+static_assert(sizeof(sjtu::map<int, int, std::less<int>, sjtu::count_stats>) ==
+              sizeof(sjtu::map<int, int>) + sizeof(sjtu::container_stats),
+              "the stats policy base must not add padding");
+
+int main () {
+	sjtu::map<int, int> plain;
+	plain[1] = 1;
+	sjtu::container_stats zero = plain.stats();
+	printf("%llu %llu\n", zero.allocations, zero.rotations);
+
+	sjtu::map<int, int, std::less<int>, sjtu::count_stats> m;
+	for (int i = 0; i < 1000; i++) {
+		m[i] = i;
+	}
+	print("ascending", m);
+	sjtu::container_stats before = m.stats();
+	for (int i = 0; i < 1000; i++) {
+		m.insert(sjtu::pair<const int, int>(i, i));
+	}
+	sjtu::container_stats after = m.stats();
+	printf("duplicates allocate %llu\n", after.allocations - before.allocations);
+	for (int i = 0; i < 1000; i += 2) {
+		m.erase(m.find(i));
+	}
+	print("erase", m);
+	sjtu::map<int, int, std::less<int>, sjtu::count_stats> copy(m);
+	print("copy", copy);
+	copy.clear();
+	print("clear", copy);
+	footprint("m", m);
+	footprint("clear", copy);
+
+	// map has no move constructor or assignment: an rvalue takes the copy paths and both sides must add up
+	sjtu::map<int, int, std::less<int>, sjtu::count_stats> moved(std::move(m));
+	footprint("moved", moved);
+	footprint("moved from", m);
+	for (int i = 1; i < 1000; i += 4) {
+		moved.erase(moved.find(i));
+	}
+	m = std::move(moved);
+	footprint("move assigned", m);
+	footprint("move assigned from", moved);
+	m = m;
+	footprint("self assigned", m);
+	return 0;
+}
@@ -0,0 +1,89 @@
+// map: how many times insert, operator[] and find copy or move keys and values
+
+#include <cstdio>
+#include <functional>
+#include <utility>
+#include <vector>
+#include "../../map.hpp"
+
+struct counts {
+	long copies = 0, moves = 0, assignments = 0;
+};
+
+// the kind, 0 for keys and 1 for values, keeps their counts apart
+template<int kind>
+class counted {
+public:
+	static counts n;
+	int x;
+	counted () : x(0) {}
+	counted (int x) : x(x) {}
+	counted (const counted &other) : x(other.x) { n.copies++; }
+	counted (counted &&other) : x(other.x) { n.moves++; }
+	counted &operator= (const counted &other) {
+		x = other.x;
+		n.assignments++;
+		return *this;
+	}
+	counted &operator= (counted &&other) {
+		x = other.x;
+		n.assignments++;
+		return *this;
+	}
+	bool operator< (const counted &other) const { return x < other.x; }
+};
+
+template<int kind>
+counts counted<kind>::n;
+
+typedef counted<0> Key;
+typedef counted<1> Value;
+typedef sjtu::map<Key, Value> Map;
+
+void reset () {
+	Key::n = counts();
+	Value::n = counts();
+}
+
+void print (const char *name) {
+	printf("%s: key copies %ld moves %ld assignments %ld, value copies %ld moves %ld assignments %ld\n", name,
+	       Key::n.copies, Key::n.moves, Key::n.assignments, Value::n.copies, Value::n.moves, Value::n.assignments);
+	reset();
+}
+
+int main () {
+	Map m;
+	std::vector<Map::value_type> values;
+	values.reserve(1000);
+	for (int i = 0; i < 1000; i++) {
+		values.emplace_back(Key(i), Value(i));
+	}
+	Map::value_type kv(Key(0), Value(0));
+	reset();
+	// the key is const and has to be copied, the value is moved; rebalancing never touches either
+	for (int i = 0; i < 1000; i++) {
+		m.insert(std::move(values[i]));
+	}
+	print("insert 1000 rvalues");
+	m.insert(kv);
+	print("insert existing lvalue");
+	Map::value_type fresh(Key(1000), Value(1000));
+	reset();
+	m.insert(fresh);
+	print("insert new lvalue");
+	Map::value_type duplicate(Key(1000), Value(1));
+	reset();
+	m.insert(std::move(duplicate));
+	print("insert existing rvalue");
+	Key k(2000);
+	reset();
+	// the value is constructed in place, only the assignment below touches it
+	m[k] = Value(7);
+	print("operator[] new key");
+	m[k].x = 8;
+	print("operator[] existing key");
+	bool found = m.find(k) != m.end() && m.find(Key(3000)) == m.end() && m.find(k)->second.x == 8;
+	print("find");
+	printf("found %d size %d\n", (int) found, (int) m.size());
+	return 0;
+}
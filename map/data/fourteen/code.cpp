@@ -0,0 +1,62 @@
+// concurrent_map: a writer erases and reinserts odd keys while readers check that
+// the even keys, which are never erased, are always found and that a snapshot never changes
+
+#include <iostream>
+#include <cstdio>
+#include <thread>
+#include <atomic>
+#include <vector>
+#include "../../concurrent_map.hpp"
+
+const int N = 1000, READERS = 3, ROUNDS = 30;
+
+int main () {
+	sjtu::concurrent_map<int, int> map;
+	for (int i = 0; i < N; i++) {
+		map.insert(sjtu::pair<int, int>(i * 1201 % N, i * 1201 % N));
+	}
+	std::atomic<bool> done(false);
+	std::atomic<long> missed(0), changed(0);
+	std::vector<std::thread> readers;
+	for (int t = 0; t < READERS; t++) {
+		readers.emplace_back([&, t] {
+			unsigned seed = t + 1;
+			while (!done.load()) {
+				auto snap = map.snap();
+				long before = 0, sum = 0;
+				for (auto it = snap.begin(); it != snap.end(); ++it) {
+					before++;
+					sum += it->first;
+				}
+				for (int i = 0; i < 2000; i++) {
+					seed = seed * 1103515245u + 12345u;
+					int key = (seed >> 8) % N & ~1, value = -1;
+					if (!map.find(key, value) || value != key) missed++;
+					if (snap.count(key) == 0) missed++;
+				}
+				long after = 0, check = 0;
+				for (auto it = snap.begin(); it != snap.end(); ++it) {
+					after++;
+					check += it->first;
+				}
+				if (after != before || check != sum) changed++;
+			}
+		});
+	}
+	for (int r = 0; r < ROUNDS; r++) {
+		for (int i = 1; i < N; i += 2) {
+			map.erase((i * 1201 + r) % N | 1);
+		}
+		for (int i = 1; i < N; i += 2) {
+			map.insert(sjtu::pair<int, int>(i, i));
+		}
+	}
+	done = true;
+	for (auto &t : readers) t.join();
+	std::cout << "size:" << map.size() << std::endl;
+	std::cout << "missed:" << missed.load() << " changed:" << changed.load() << std::endl;
+	std::cout << (missed.load() == 0 && changed.load() == 0 ? "PASSED" : "FAILED") << std::endl;
+	map.clear();
+	std::cout << "pending:" << map.pending() << std::endl;
+	return 0;
+}
@@ -0,0 +1,125 @@
+// unordered_map: random operations checked against std::map
+
+#include <iostream>
+#include <cstdio>
+#include <map>
+#include <string>
+#include "../../unordered_map.hpp"
+
+long long aa = 13131, bb = 5353, MOD = (long long) (1e9 + 7), now = 1;
+
+int rand () {
+	for (int i = 1; i < 3; i++)
+		now = (now * aa + bb) % MOD;
+	return now;
+}
+
+class Key {
+public:
+	static int counter;
+	int x;
+	Key (int x) : x(x) { counter++; }
+	Key (const Key &other) : x(other.x) { counter++; }
+	~Key () { counter--; }
+};
+
+int Key::counter = 0;
+
+struct KeyHash {
+	size_t operator() (const Key &k) const { return k.x / 7; }
+};
+
+struct KeyEqual {
+	bool operator() (const Key &a, const Key &b) const { return a.x == b.x; }
+};
+
+typedef sjtu::unordered_map<Key, std::string, KeyHash, KeyEqual> Map;
+
+bool same (const Map &a, const std::map<int, std::string> &b) {
+	if (a.size() != b.size()) return false;
+	size_t cnt = 0;
+	for (auto it = a.cbegin(); it != a.cend(); ++it, ++cnt) {
+		auto jt = b.find(it->first.x);
+		if (jt == b.end() || jt->second != it->second) return false;
+	}
+	return cnt == b.size();
+}
+
+void test_random () {
+	puts("Test: random operations");
+	Map map;
+	std::map<int, std::string> ref;
+	bool ok = true;
+	for (int i = 0; i < 200000; i++) {
+		int op = rand() % 5, key = rand() % 20000;
+		std::string val = std::to_string(rand() % 1000);
+		if (op == 0) {
+			auto r = map.insert(Map::value_type(Key(key), val));
+			bool b = ref.insert(std::make_pair(key, val)).second;
+			ok &= r.second == b && r.first->first.x == key;
+		} else if (op == 1) {
+			map[Key(key)] = val;
+			ref[key] = val;
+		} else if (op == 2) {
+			auto it = map.find(Key(key));
+			ok &= (it != map.end()) == (ref.count(key) == 1);
+			if (it != map.end()) {
+				map.erase(it);
+				ref.erase(key);
+			}
+		} else if (op == 3) {
+			ok &= map.count(Key(key)) == ref.count(key);
+		} else {
+			try {
+				std::string got = map.at(Key(key));
+				ok &= ref.count(key) == 1 && got == ref[key];
+			} catch (sjtu::index_out_of_bound) {
+				ok &= ref.count(key) == 0;
+			}
+		}
+	}
+	ok &= same(map, ref);
+	std::cout << "size:" << map.size() << std::endl;
+	std::cout << (ok ? "PASSED" : "FAILED") << std::endl;
+}
+
+void test_copy () {
+	puts("Test: copy and clear");
+	Map a;
+	std::map<int, std::string> ref;
+	for (int i = 0; i < 5000; i++) {
+		a[Key(i * 3)] = std::to_string(i);
+		ref[i * 3] = std::to_string(i);
+	}
+	Map b(a), c;
+	c = b;
+	a.clear();
+	bool ok = a.empty() && same(b, ref) && same(c, ref);
+	for (int i = 0; i < 5000; i += 2) {
+		b.erase(b.find(Key(i * 3)));
+	}
+	ok &= b.size() == 2500 && same(c, ref);
+	std::cout << (ok ? "PASSED" : "FAILED") << std::endl;
+}
+
+void test_exception () {
+	puts("Test: exceptions");
+	Map a;
+	int caught = 0;
+	try { a.erase(a.end()); } catch (sjtu::invalid_iterator) { caught++; }
+	try { a.at(Key(1)); } catch (sjtu::index_out_of_bound) { caught++; }
+	try { ++a.end(); } catch (sjtu::invalid_iterator) { caught++; }
+	try { --a.begin(); } catch (sjtu::invalid_iterator) { caught++; }
+	a[Key(1)] = "1";
+	Map b;
+	try { b.erase(a.begin()); } catch (sjtu::invalid_iterator) { caught++; }
+	std::cout << "caught:" << caught << std::endl;
+}
+
+int main () {
+	test_random();
+	test_copy();
+	test_exception();
+	std::cout << Key::counter << std::endl;
+	return 0;
+}
@@ -0,0 +1,94 @@
+// compact_map: random operations and both iteration directions checked against std::map
+
+#include <iostream>
+#include <cstdio>
+#include <map>
+#include <string>
+#include "../../compact_map.hpp"
+
+long long aa = 13131, bb = 5353, MOD = (long long) (1e9 + 7), now = 1;
+
+int rand () {
+	for (int i = 1; i < 3; i++)
+		now = (now * aa + bb) % MOD;
+	return now;
+}
+
+class Integer {
+public:
+	static int counter;
+	int val;
+	Integer (int val) : val(val) { counter++; }
+	Integer (const Integer &rhs) : val(rhs.val) { counter++; }
+	Integer &operator= (const Integer &rhs) = delete;
+	~Integer () { counter--; }
+};
+
+int Integer::counter = 0;
+
+struct Compare {
+	bool operator() (const Integer &lhs, const Integer &rhs) const { return lhs.val > rhs.val; }
+};
+
+typedef sjtu::compact_map<Integer, std::string, Compare> Map;
+
+bool same (Map &a, const std::map<int, std::string, std::greater<int>> &b) {
+	if (a.size() != b.size()) return false;
+	auto it = a.begin();
+	for (auto jt = b.begin(); jt != b.end(); ++jt, ++it) {
+		if (it == a.end() || it->first.val != jt->first || it->second != jt->second) return false;
+	}
+	if (it != a.end()) return false;
+	auto rt = b.rbegin();
+	for (it = a.end(); it != a.begin(); ++rt) {
+		--it;
+		if (it->first.val != rt->first) return false;
+	}
+	return rt == b.rend();
+}
+
+int main () {
+	puts("Test: random operations");
+	Map map;
+	std::map<int, std::string, std::greater<int>> ref;
+	bool ok = true;
+	for (int i = 0; i < 100000; i++) {
+		int op = rand() % 4, key = rand() % 5000;
+		std::string val = std::to_string(rand() % 100);
+		if (op == 0) {
+			auto r = map.insert(Map::value_type(Integer(key), val));
+			ok &= r.second == ref.insert(std::make_pair(key, val)).second && r.first->first.val == key;
+		} else if (op == 1) {
+			map[Integer(key)] = val;
+			ref[key] = val;
+		} else if (op == 2) {
+			auto it = map.find(Integer(key));
+			ok &= (it != map.end()) == (ref.count(key) == 1);
+			if (it != map.end()) {
+				map.erase(it);
+				ref.erase(key);
+			}
+		} else {
+			ok &= map.count(Integer(key)) == ref.count(key);
+		}
+		if (i % 10000 == 0) ok &= same(map, ref);
+	}
+	ok &= same(map, ref);
+	std::cout << "size:" << map.size() << std::endl;
+	std::cout << (ok ? "PASSED" : "FAILED") << std::endl;
+
+	puts("Test: copy and exceptions");
+	Map copy(map);
+	map.clear();
+	ok = same(copy, ref) && map.empty();
+	int caught = 0;
+	try { --map.begin(); } catch (sjtu::invalid_iterator) { caught++; }
+	try { ++map.end(); } catch (sjtu::invalid_iterator) { caught++; }
+	try { map.erase(copy.begin()); } catch (sjtu::invalid_iterator) { caught++; }
+	try { map.at(Integer(1)); } catch (sjtu::index_out_of_bound) { caught++; }
+	try { --copy.begin(); } catch (sjtu::invalid_iterator) { caught++; }
+	std::cout << (ok ? "PASSED" : "FAILED") << " caught:" << caught << std::endl;
+	copy.clear();
+	std::cout << Integer::counter << std::endl;
+	return 0;
+}
@@ -0,0 +1,47 @@
+// map: Util::Bint keys ordered across signs and lengths, and small Bints never touch the heap
+
+#include <cstdio>
+#include <iostream>
+#include <string>
+#include "../../map.hpp"
+#include "../class-bint.hpp"
+#include "../alloc-counter.hpp"
+
+int main () {
+	const char *keys[] = {"0", "-1", "1", "4294967295", "4294967296", "-4294967296", "18446744073709551616",
+	                      "-18446744073709551617", "79228162514264337593543950335", "79228162514264337593543950336",
+	                      "-99999999999999999999999999999999999999999999999999", "123456789012345678901234567890123456789",
+	                      "-0", "000123"};
+	sjtu::map<Util::Bint, int> m;
+	for (int i = 0; i < (int) (sizeof(keys) / sizeof(keys[0])); i++) {
+		m[Util::Bint(std::string(keys[i]))] = i;
+	}
+	for (auto it = m.begin(); it != m.end(); ++it) {
+		std::cout << it->first << " " << it->second << std::endl;
+	}
+
+	// sums and differences against the products, through parsing and printing
+	Util::Bint a(std::string("-98765432109876543210987654321098765432109876543210"));
+	Util::Bint b(std::string("12345678901234567890123456789"));
+	std::cout << a + b << std::endl << a - b << std::endl << b - a << std::endl << a * b << std::endl;
+	std::cout << (a + b - b == a) << (a * b - a * b == Util::Bint(0)) << (-(a * b) == (-a) * b) << std::endl;
+	Util::Bint power(1), two(2);
+	for (int i = 0; i < 200; i++) {
+		power = power * two;
+	}
+	std::cout << power << std::endl << power - Util::Bint(1) + Util::Bint(1) - power << std::endl;
+
+	Util::Bint big(9223372036854775807LL), sum;
+	long long total = 0;
+	auto arithmetic = [&] {
+		for (int i = 0; i < 1000; i++) {
+			Util::Bint x(1000003LL * i), y = x * x + big;
+			sum = sum + y - x;
+			total += m.count(y);
+		}
+	};
+	EXPECT_NO_ALLOC("small values", arithmetic());
+	EXPECT_NO_ALLOC("find small keys", for (int i = -5; i < 5; i++) total += m.find(Util::Bint(i)) != m.end());
+	std::cout << sum << " " << total << std::endl;
+	return 0;
+}
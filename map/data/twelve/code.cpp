@@ -0,0 +1,39 @@
+// map: lookups and iteration must not allocate, checked with the allocation counter
+
+#include <cstdio>
+#include <string>
+#include "../../map.hpp"
+#include "../alloc-counter.hpp"
+
+int main () {
+	sjtu::map<int, int> m;
+	for (int i = 0; i < 1000; i++) {
+		m[i * 2] = i;
+	}
+	const sjtu::map<int, int> &c = m;
+	long long sum = 0;
+	EXPECT_NO_ALLOC("find", for (int i = 0; i < 2000; i += 2) sum += m.find(i)->second);
+	EXPECT_NO_ALLOC("find missing", for (int i = 1; i < 2000; i += 2) sum += m.find(i) == m.end());
+	EXPECT_NO_ALLOC("const find", for (int i = 0; i < 2000; i++) sum += c.find(i) == c.cend());
+	EXPECT_NO_ALLOC("count", for (int i = 0; i < 2000; i++) sum += m.count(i));
+	EXPECT_NO_ALLOC("at", for (int i = 0; i < 2000; i += 2) sum += m.at(i) + c.at(i));
+	EXPECT_NO_ALLOC("operator[] existing", for (int i = 0; i < 2000; i += 2) sum += m[i]);
+	EXPECT_NO_ALLOC("iterate", for (auto it = m.begin(); it != m.end(); ++it) sum += it->second);
+	EXPECT_NO_ALLOC("iterate backwards", for (auto it = --m.end(); it != m.begin(); --it) sum += it->second);
+	EXPECT_NO_ALLOC("size", sum += m.size() + m.empty());
+	printf("%lld\n", sum);
+
+	// the counter itself: one entry per insertion, nothing left after clear
+	printf("insert: %lld\n", alloc_counter::count([&] { m[-1] = 0; }));
+	alloc_counter::scope clearing;
+	m.clear();
+	printf("clear: %lld %lld\n", clearing.since().allocations, clearing.since().frees);
+
+	sjtu::map<std::string, int> names;
+	names["alpha"] = 1;
+	names["beta"] = 2;
+	std::string beta = "beta", gamma = "gamma";
+	EXPECT_NO_ALLOC("string find", sum += names.find(beta)->second + (names.find(gamma) == names.end()));
+	EXPECT_NO_ALLOC("string count", sum += names.count(gamma));
+	return 0;
+}
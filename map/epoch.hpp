@@ -0,0 +1,190 @@
+//epoch based memory reclamation
+//readers pin the current epoch, writers retire nodes and free them two epochs later
+#ifndef SJTU_EPOCH_HPP
+#define SJTU_EPOCH_HPP
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <thread>
+#include <vector>
+
+namespace sjtu {
+
+    class epoch_domain {
+    public:
+        /**
+         * number of readers that can be inside a critical section at the same time.
+         * a reader that finds every slot busy spins until one is released.
+         */
+        static const int MAX_READERS = 128;
+
+        /**
+         * collect only scans the reader slots once this many nodes have been retired since the last scan.
+         */
+        static const size_t COLLECT_EVERY = 256;
+
+    private:
+        static const std::uint64_t IDLE = 0;
+
+        struct alignas(64) slot {
+            // IDLE, or (epoch << 1 | 1) while a reader is inside
+            std::atomic<std::uint64_t> state;
+
+            slot () : state(IDLE) {}
+        };
+
+        struct retired {
+            void *pointer;
+            void (*deleter) (void *);
+            std::uint64_t epoch;
+        };
+
+        alignas(64) std::atomic<std::uint64_t> global;
+        slot slots[MAX_READERS];
+        // only touched by the writer, who is serialized by the container
+        std::vector<retired> garbage;
+        size_t since = 0;
+
+        static int home_slot () {
+            return (int) (std::hash<std::thread::id>()(std::this_thread::get_id()) % MAX_READERS);
+        }
+
+        int enter () {
+            int i = home_slot();
+            for (;;) {
+                std::uint64_t expected = IDLE;
+                std::uint64_t e = global.load();
+                if (slots[i].state.compare_exchange_strong(expected , e << 1 | 1)) {
+                    // the writer may have advanced between the load and the publication
+                    for (std::uint64_t now = global.load(); now != e; now = global.load()) {
+                        e = now;
+                        slots[i].state.store(e << 1 | 1);
+                    }
+                    return i;
+                }
+                if (++i == MAX_READERS) {
+                    i = 0;
+                    std::this_thread::yield();
+                }
+            }
+        }
+
+        void leave (int i) {
+            slots[i].state.store(IDLE , std::memory_order_release);
+        }
+
+        bool try_advance () {
+            std::uint64_t e = global.load();
+            for (int i = 0; i < MAX_READERS; i++) {
+                std::uint64_t s = slots[i].state.load();
+                if (s != IDLE && (s >> 1) != e) {
+                    return false;
+                }
+            }
+            global.compare_exchange_strong(e , e + 1);
+            return true;
+        }
+
+        template<class T>
+        static void destroy (void *p) {
+            delete static_cast<T *>(p);
+        }
+
+    public:
+        /**
+         * RAII critical section for a reader.
+         * nodes reachable when the guard was taken stay alive until it is released.
+         */
+        class guard {
+            friend class epoch_domain;
+
+        private:
+            epoch_domain *domain;
+            int index;
+
+            explicit guard (epoch_domain *domain) : domain(domain) , index(domain->enter()) {}
+
+        public:
+            guard (const guard &other) = delete;
+
+            guard &operator= (const guard &other) = delete;
+
+            guard (guard &&other) noexcept : domain(other.domain) , index(other.index) {
+                other.domain = nullptr;
+            }
+
+            ~guard () {
+                if (domain != nullptr) {
+                    domain->leave(index);
+                }
+            }
+        };
+
+        epoch_domain () : global(2) {}
+
+        epoch_domain (const epoch_domain &other) = delete;
+
+        epoch_domain &operator= (const epoch_domain &other) = delete;
+
+        ~epoch_domain () {
+            for (size_t i = 0; i < garbage.size(); i++) {
+                garbage[i].deleter(garbage[i].pointer);
+            }
+        }
+
+        guard pin () {
+            return guard(this);
+        }
+
+        /**
+         * hand a node that is no longer reachable from the shared root to the domain.
+         * must only be called by the (single) writer.
+         */
+        template<class T>
+        void retire (T *p) {
+            garbage.push_back(retired{p , &destroy<T> , global.load(std::memory_order_relaxed)});
+            since++;
+        }
+
+        /**
+         * reclaim, once every COLLECT_EVERY retirements: cheap enough to call after every write.
+         * must only be called by the (single) writer.
+         */
+        void collect () {
+            if (since >= COLLECT_EVERY) {
+                reclaim();
+            }
+        }
+
+        /**
+         * try to move the epoch forward and free everything retired two epochs ago.
+         * must only be called by the (single) writer.
+         */
+        void reclaim () {
+            since = 0;
+            if (garbage.empty()) {
+                return;
+            }
+            try_advance();
+            std::uint64_t e = global.load();
+            size_t kept = 0;
+            for (size_t i = 0; i < garbage.size(); i++) {
+                if (garbage[i].epoch + 2 <= e) {
+                    garbage[i].deleter(garbage[i].pointer);
+                } else {
+                    garbage[kept++] = garbage[i];
+                }
+            }
+            garbage.resize(kept);
+        }
+
+        size_t pending () const {
+            return garbage.size();
+        }
+    };
+
+}
+
+#endif
@@ -6,40 +6,54 @@
 // only for std::less<T>
 #include <functional>
 #include <cstddef>
+#include <cstdint>
+#include <tuple>
+#include <utility>
 #include "utility.hpp"
 #include "exceptions.hpp"
+#include "stats.hpp"
 
 namespace sjtu {
     const bool BLACK = false;
     const bool RED = true;
 
+    /**
+     * Stats is the statistics policy, see stats.hpp; no_stats costs nothing.
+     */
     template<
             class Key ,
             class Value ,
-            class Compare = std::less<Key>
+            class Compare = std::less<Key> ,
+            class Stats = no_stats
     >
-    class map {
+    class map : private Stats {
     public:
         /**
          * the internal type of data.
          * it should have a default constructor, a copy constructor.
          * You can use sjtu::map as value_type by typedef.
          */
-        typedef pair<Key,Value> value_type;
+        typedef pair<const Key,Value> value_type;
         struct Entry {
-            Key first;
-            Value second;
-            bool color = BLACK;
+            value_type kv;
             Entry *left;
             Entry *right;
-            Entry *parent;
+            // the parent pointer, with the color kept in its lowest bit (entries are at least pointer aligned)
+            uintptr_t parentcolor;
 
-            Entry (Key key , Value val , bool color , Entry *left , Entry *right , Entry *parent) : first(key) ,
-                                                                                                    second(val) ,
-                                                                                                    color(color) ,
-                                                                                                    left(left) ,
-                                                                                                    right(right) ,
-                                                                                                    parent(parent) {}
+            // the remaining arguments construct kv in place
+            template<class... Args>
+            Entry (bool color , Entry *left , Entry *right , Entry *parent , Args &&... args) :
+                    kv(std::forward<Args>(args)...) , left(left) , right(right) ,
+                    parentcolor(reinterpret_cast<uintptr_t>(parent) | color) {}
+
+            Entry *parent () const { return reinterpret_cast<Entry *>(parentcolor & ~(uintptr_t) 1); }
+
+            bool color () const { return parentcolor & 1; }
+
+            void setparent (Entry *p) { parentcolor = reinterpret_cast<uintptr_t>(p) | (parentcolor & 1); }
+
+            void setcolor (bool c) { parentcolor = (parentcolor & ~(uintptr_t) 1) | c; }
 
             Entry (const Entry &other) = default;
         };
@@ -96,10 +110,10 @@ namespace sjtu {
                     }
                 } else {
                     auto tmp = pointer;
-                    pointer = pointer->parent;
+                    pointer = pointer->parent();
                     while (pointer!= nullptr &&tmp==pointer->right) {
                         tmp=pointer;
-                        pointer=pointer->parent;
+                        pointer=pointer->parent();
 
                     }
                 }
@@ -131,10 +145,10 @@ namespace sjtu {
                     }
                 } else {
                     auto tmp = pointer;
-                    pointer = pointer->parent;
+                    pointer = pointer->parent();
                     while (pointer!= nullptr &&tmp==pointer->left) {
                         tmp=pointer;
-                        pointer=pointer->parent;
+                        pointer=pointer->parent();
                     }
                 }
 
@@ -144,7 +158,7 @@ namespace sjtu {
             /**
              * a operator to check whether two iterators are same (pointing to the same memory).
              */
-            Entry &operator* () const { return *pointer; }
+            value_type &operator* () const { return pointer->kv; }
 
             bool operator== (const iterator &rhs) const { return pointer == rhs.pointer&&Map==rhs.Map; }
 
@@ -158,7 +172,7 @@ namespace sjtu {
             bool operator!= (const const_iterator &rhs) const { return !((*this) == rhs); }
 
 
-            Entry *operator-> () const noexcept { return pointer; }
+            value_type *operator-> () const noexcept { return &pointer->kv; }
             friend class const_iterator;
         };
 
@@ -183,17 +197,28 @@ namespace sjtu {
         int length = 0;
         Entry *root;
 
+        template<class... Args>
+        Entry *create (Args &&... args) {
+            Stats::on_allocate(sizeof(Entry));
+            return new Entry(std::forward<Args>(args)...);
+        }
+
+        void destroy (Entry *p) {
+            Stats::on_deallocate(sizeof(Entry));
+            delete p;
+        }
+
         Entry *copytree (Entry *other) {
             if (other == nullptr) {
                 return nullptr;
             }
-            Entry* tmp= new Entry(other->first , other->second , other->color , copytree(other->left) , copytree
-            (other->right) , nullptr);
+            Entry* tmp= create(other->color() , copytree(other->left) , copytree(other->right) , nullptr ,
+                                  other->kv);
             if (tmp->left != nullptr) {
-                tmp->left->parent=tmp;
+                tmp->left->setparent(tmp);
             }
             if (tmp->right != nullptr) {
-                tmp->right->parent=tmp;
+                tmp->right->setparent(tmp);
             }
             return tmp;
 
@@ -203,7 +228,7 @@ namespace sjtu {
             if (root != nullptr) {
                 cleartree(root->left);
                 cleartree(root->right);
-                delete root;
+                destroy(root);
             }
             root= nullptr;
         }
@@ -236,18 +261,29 @@ namespace sjtu {
 
 
     private:
-        Entry *at (Entry *root , const Key &key)const {
-            Compare comp =Compare();
-            if (root == nullptr) {
-                throw index_out_of_bound();
+        // the entry with key, nullptr if there is none
+        // it never throws, so find and count do not allocate an exception for a missing key
+        Entry *lookup (const Key &key) const {
+            Compare comp = Compare();
+            auto p = root;
+            while (p != nullptr) {
+                if (comp(p->kv.first , key)) {
+                    p = p->right;
+                } else if (comp(key , p->kv.first)) {
+                    p = p->left;
+                } else {
+                    return p;
+                }
             }
-            if (comp(root->first , key)) {
-                return at(root->right , key);
-            } else if (comp(key , root->first)) {
-                return at(root->left , key);
-            } else {
-                return root;
+            return nullptr;
+        }
+
+        Entry *locate (const Key &key) const {
+            auto p = lookup(key);
+            if (p == nullptr) {
+                throw index_out_of_bound();
             }
+            return p;
         }
 
     public:
@@ -258,11 +294,11 @@ namespace sjtu {
                 * If no such element exists, an exception of type `index_out_of_bound'
                 */
         Value &at (const Key &key) {
-            return at(root , key)->second;
+            return locate(key)->kv.second;
         }
 
         const Value &at (const Key &key) const {
-            return at(root , key)->second;
+            return locate(key)->kv.second;
         }
 
         /**
@@ -272,14 +308,12 @@ namespace sjtu {
          *   performing an insertion if such key does not already exist.
          */
         Value &operator[] (const Key &key) {
-            try {
-                return at(key);
-            } catch (index_out_of_bound) {
-                Entry* a;
-                root=(insert(root,pair<Key , Value>(key , Value()),a));
-                length++;
-                return this->at(key);
+            auto p = lookup(key);
+            if (p != nullptr) {
+                return p->kv.second;
             }
+            return emplace(key , std::piecewise_construct , std::forward_as_tuple(key) ,
+                           std::tuple<>()).first->second;
         }
 
         /**
@@ -354,22 +388,24 @@ namespace sjtu {
 
     private:
         bool isred (Entry *root) {
-            return root != nullptr && root->color == RED;
+            return root != nullptr && root->color() == RED;
         }
 
 
-        Entry *insert (Entry *root , const pair<Key , Value> &keyval , Entry *&result) {
+        // args construct the new entry's kv, it is only built once the key is known to be absent
+        template<class... Args>
+        Entry *insert (Entry *root , const Key &key , Entry *&result , Args &&... args) {
             Compare comp=Compare();
             if (root == nullptr) {
-                result = new Entry(keyval.first , keyval.second , RED , nullptr , nullptr , nullptr);
+                result = create(RED , nullptr , nullptr , nullptr , std::forward<Args>(args)...);
                 return result;
             }
-            if (comp(root->first,keyval.first)) {
-                root->right = insert(root->right , keyval,result);
-                root->right->parent = root;
-            } else if (comp(keyval.first, root->first)) {
-                root->left = insert(root->left , keyval,result);
-                root->left->parent = root;
+            if (comp(root->kv.first,key)) {
+                root->right = insert(root->right , key , result , std::forward<Args>(args)...);
+                root->right->setparent(root);
+            } else if (comp(key, root->kv.first)) {
+                root->left = insert(root->left , key , result , std::forward<Args>(args)...);
+                root->left->setparent(root);
             } else {
                 result=root;
                 throw InsertionFailure();
@@ -387,18 +423,21 @@ namespace sjtu {
         *   the iterator to the new element (or the element that prevented the insertion),
         *   the second one is true if insert successfully, or false.
         */
-        pair<iterator , bool> insert (const pair<Key , Value> &keyval) {
-            Entry *p;
-            if (root == nullptr) {
-                root = new Entry(keyval.first , keyval.second , BLACK , nullptr , nullptr ,
-                                 nullptr);
-                length++;
-                return pair<iterator,bool>(iterator(p,this),true);
+        pair<iterator , bool> insert (const value_type &keyval) {
+            return emplace(keyval.first , keyval);
+        }
 
-            }
+        pair<iterator , bool> insert (value_type &&keyval) {
+            return emplace(keyval.first , std::move(keyval));
+        }
+
+    private:
+        template<class... Args>
+        pair<iterator , bool> emplace (const Key &key , Args &&... args) {
+            Entry *p;
             try {
-                root=insert(root , keyval , p);
-                root->color = BLACK;
+                root=insert(root , key , p , std::forward<Args>(args)...);
+                root->setcolor(BLACK);
                 length++;
                 return pair<iterator , bool>(iterator(p,this) , true);
             } catch (InsertionFailure) {
@@ -407,8 +446,6 @@ namespace sjtu {
 
         }
 
-    private:
-
         Entry *fixup (Entry *root) {
             if (root == nullptr) {
                 return root;
@@ -458,7 +495,7 @@ namespace sjtu {
             }
             root->left = deleteMin(root->left , deleted);
             if(root->left!= nullptr) {
-                root->left->parent = root;
+                root->left->setparent(root);
             }
             root=fixup(root);
             return root;
@@ -469,7 +506,7 @@ namespace sjtu {
             if (root == nullptr) {
                 throw invalid_iterator();
             }
-            if (comp(key, root->first)) {
+            if (comp(key, root->kv.first)) {
                 if (root->left!= nullptr&&!isred(root->left) && !isred(root->left->left)) {
                     root = moveredleft(root);
                 }
@@ -478,34 +515,34 @@ namespace sjtu {
                 if (isred(root->left)) {
                     root = rotateright(root);
                 }
-                if (!comp(key , root->first) && !comp(root->first , key) && root->right == nullptr) {
-                    delete root;
+                if (!comp(key , root->kv.first) && !comp(root->kv.first , key) && root->right == nullptr) {
+                    destroy(root);
                     return nullptr;
                 }
                 if (!isred(root->right) && !isred(root->right->left)) {
                     root = moveredright(root);
                 }
-                if(!comp(key , root->first) && !comp(root->first , key)) {
+                if(!comp(key , root->kv.first) && !comp(root->kv.first , key)) {
 
                     auto tmp = (++iterator(root,this)).pointer;
                     Entry* deleted;
                     root->right = deleteMin(root->right ,deleted);
-                    if (root->parent != nullptr&&root->parent->left==root) {
-                        root->parent->left=deleted;
-                    } else if (root->parent != nullptr) {
-                        root->parent->right=deleted;
+                    if (root->parent() != nullptr&&root->parent()->left==root) {
+                        root->parent()->left=deleted;
+                    } else if (root->parent() != nullptr) {
+                        root->parent()->right=deleted;
                     }
                     if (root->left != nullptr) {
-                        root->left->parent=deleted;
+                        root->left->setparent(deleted);
                     }
                     if (root->right != nullptr) {
-                        root->right->parent=deleted;
+                        root->right->setparent(deleted);
                     }
-                    deleted->color=root->color;
-                    deleted->parent=root->parent;
+                    deleted->setcolor(root->color());
+                    deleted->setparent(root->parent());
                     deleted->right=root->right;
                     deleted->left=root->left;
-                    delete root;
+                    destroy(root);
                     root=deleted;
                 } else {
                     root->right= erase(root->right , key , comp );
@@ -528,7 +565,7 @@ namespace sjtu {
                 throw invalid_iterator();
             }
             if (!isred(root->left) && !isred(root->right)) {
-                root->color = RED;
+                root->setcolor(RED);
             }
             Compare comp=Compare();
 
@@ -536,7 +573,7 @@ namespace sjtu {
             length--;
 
             if(root!= nullptr) {
-                root->color = BLACK;
+                root->setcolor(BLACK);
             }
         }
 
@@ -548,12 +585,7 @@ namespace sjtu {
          * The default method of check the equivalence is !(a < b || b > a)
          */
         size_t count (const Key &key) const {
-            try {
-                at(root , key);
-                return 1;
-            } catch (index_out_of_bound) {
-                return 0;
-            }
+            return lookup(key) == nullptr ? 0 : 1;
         }
 
         /**
@@ -563,71 +595,83 @@ namespace sjtu {
          *   If no such element is found, past-the-end (see end()) iterator is returned.
          */
         iterator find (const Key &key) {
-            try {
-                auto p = at(root , key);
-                return iterator(p,this);
-            } catch (index_out_of_bound) {
-                return end();
-            }
+            return iterator(lookup(key) , this);
+        }
 
+        const_iterator find (const Key &key) const {
+            return const_iterator(lookup(key) , const_cast<map*>(this));
+        }
 
+        /**
+         * what this map has done so far, all zero unless Stats counts.
+         */
+        container_stats stats () const {
+            return Stats::snapshot();
         }
 
-        const_iterator find (const Key &key) const {
-            try {
-                auto p = at(root , key);
-                return const_iterator(p, const_cast<map*>(this));
-            } catch (index_out_of_bound) {
-                return const_iterator(iterator(nullptr, const_cast<map*>(this)));
-            }
+        /**
+         * bytes held, the children and parent pointers of every entry count as overhead.
+         */
+        container_memory memory_usage () const {
+            container_memory m;
+            m.payload = sizeof(value_type) * length;
+            m.overhead = sizeof(map) + (sizeof(Entry) - sizeof(value_type)) * length;
+            return m;
         }
 
     private:
         void colorflip (Entry *root) {
+            Stats::on_flip();
 
-            root->left->color = !root->left->color;
-            root->color = !root->color;
-            root->right->color = !root->right->color;
+            root->left->setcolor(!root->left->color());
+            root->setcolor(!root->color());
+            root->right->setcolor(!root->right->color());
         }
 
         Entry *rotateleft (Entry *root) {
+            Stats::on_rotate();
             auto tmp = root->right;
             root->right = root->right->left;
             if(root->right!=nullptr) {
-                root->right->parent = root;
+                root->right->setparent(root);
             }
             tmp->left = root;
-            if(root->parent!= nullptr) {
-                if (root->parent->left == root) {
-                    root->parent->left = tmp;
+            if(root->parent()!= nullptr) {
+                if (root->parent()->left == root) {
+                    root->parent()->left = tmp;
                 } else {
-                    root->parent->right = tmp;
+                    root->parent()->right = tmp;
                 }
             }
-            tmp->parent = root->parent;
-            root->parent = tmp;
-            std::swap(root->color , tmp->color);
+            tmp->setparent(root->parent());
+            root->setparent(tmp);
+            bool color = root->color();
+            root->setcolor(tmp->color());
+            tmp->setcolor(color);
             return tmp;
 
         }
 
         Entry *rotateright (Entry *root) {
+            Stats::on_rotate();
             auto tmp = root->left;
             root->left = root->left->right;
             if(root->left!= nullptr) {
-                root->left->parent = root;
+                root->left->setparent(root);
             }
             tmp->right = root;
-            if(root->parent!= nullptr) {
-                if (root->parent->left == root) {
-                    root->parent->left = tmp;
+            if(root->parent()!= nullptr) {
+                if (root->parent()->left == root) {
+                    root->parent()->left = tmp;
                 } else {
-                    root->parent->right = tmp;
+                    root->parent()->right = tmp;
                 }
             }
-            tmp->parent = root->parent;
-            root->parent = tmp;
-            std::swap(root->color , tmp->color);
+            tmp->setparent(root->parent());
+            root->setparent(tmp);
+            bool color = root->color();
+            root->setcolor(tmp->color());
+            tmp->setcolor(color);
             return tmp;
         }
     };
@@ -0,0 +1,400 @@
+//a simple implementation of robin hood hashing with backward shift deletion
+//same interface as sjtu::map, but elements are not ordered
+#ifndef SJTU_UNORDERED_MAP_HPP
+#define SJTU_UNORDERED_MAP_HPP
+
+// only for std::hash<T> and std::equal_to<T>
+#include <functional>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+#include <utility>
+#include "utility.hpp"
+#include "exceptions.hpp"
+
+namespace sjtu {
+
+    template<
+            class Key ,
+            class Value ,
+            class Hash = std::hash<Key> ,
+            class Equal = std::equal_to<Key>
+    >
+    class unordered_map {
+    public:
+        typedef pair<const Key , Value> value_type;
+
+        class const_iterator;
+
+        /**
+         * see BidirectionalIterator at CppReference for help.
+         * iterators are invalidated by insert (rehash may happen) and erase (elements are shifted).
+         *
+         * if there is anything wrong throw invalid_iterator.
+         */
+        class iterator {
+            friend class unordered_map;
+
+        private:
+            unordered_map *Map;
+            size_t index;
+
+        public:
+            iterator () : Map(nullptr) , index(0) {}
+
+            iterator (unordered_map *Map , size_t index) : Map(Map) , index(index) {}
+
+            iterator operator++ (int) {
+                auto tmp = *this;
+                operator++();
+                return tmp;
+            }
+
+            iterator &operator++ () {
+                if (Map == nullptr || index >= Map->capacity) {
+                    throw invalid_iterator();
+                }
+                index = Map->next(index + 1);
+                return *this;
+            }
+
+            iterator operator-- (int) {
+                auto tmp = *this;
+                operator--();
+                return tmp;
+            }
+
+            iterator &operator-- () {
+                if (Map == nullptr) {
+                    throw invalid_iterator();
+                }
+                size_t i = index;
+                while (i > 0) {
+                    if (Map->dist[--i] != 0) {
+                        index = i;
+                        return *this;
+                    }
+                }
+                throw invalid_iterator();
+            }
+
+            value_type &operator* () const {
+                if (Map == nullptr || index >= Map->capacity) {
+                    throw invalid_iterator();
+                }
+                return Map->slots[index];
+            }
+
+            value_type *operator-> () const {
+                return &operator*();
+            }
+
+            /**
+             * a operator to check whether two iterators are same (pointing to the same memory).
+             */
+            bool operator== (const iterator &rhs) const { return index == rhs.index && Map == rhs.Map; }
+
+            bool operator== (const const_iterator &rhs) const { return index == rhs.index && Map == rhs.Map; }
+
+            bool operator!= (const iterator &rhs) const { return !((*this) == rhs); }
+
+            bool operator!= (const const_iterator &rhs) const { return !((*this) == rhs); }
+
+            friend class const_iterator;
+        };
+
+        class const_iterator : public iterator {
+        public:
+            const_iterator () : iterator() {}
+
+            const_iterator (unordered_map *Map , size_t index) : iterator(Map , index) {}
+
+            const_iterator (const const_iterator &other) : iterator(other) {}
+
+            const_iterator (const iterator &other) : iterator(other) {}
+        };
+
+    private:
+        static const size_t MIN_CAPACITY = 16;
+        // dist is 0 for an empty slot, otherwise 1 + the distance from the home slot
+        static const unsigned char MAX_DIST = 255;
+
+        value_type *slots;
+        unsigned char *dist;
+        size_t capacity;
+        size_t length = 0;
+        int shift;
+
+        size_t home (const Key &key) const {
+            // fibonacci hashing, so that weak hashes like std::hash<int> still spread over the table
+            return (size_t) ((std::uint64_t) Hash()(key) * 0x9E3779B97F4A7C15ull >> shift);
+        }
+
+        size_t next (size_t i) const {
+            while (i < capacity && dist[i] == 0) {
+                i++;
+            }
+            return i;
+        }
+
+        void allocate (size_t capa) {
+            capacity = capa;
+            shift = 64;
+            for (size_t c = capa; c > 1; c >>= 1) {
+                shift--;
+            }
+            slots = (value_type *) malloc(sizeof(value_type) * capacity);
+            dist = (unsigned char *) malloc(capacity);
+            memset(dist , 0 , capacity);
+        }
+
+        void release () {
+            for (size_t i = 0; i < capacity; i++) {
+                if (dist[i] != 0) {
+                    slots[i].~value_type();
+                }
+            }
+            free(slots);
+            free(dist);
+        }
+
+        size_t locate (const Key &key) const {
+            Equal equal = Equal();
+            size_t mask = capacity - 1;
+            size_t i = home(key);
+            for (unsigned d = 1; dist[i] >= d; d++) {
+                if (equal(slots[i].first , key)) {
+                    return i;
+                }
+                i = (i + 1) & mask;
+            }
+            return capacity;
+        }
+
+        void rehash (size_t capa) {
+            auto old_slots = slots;
+            auto old_dist = dist;
+            auto old_capacity = capacity;
+            allocate(capa);
+            for (size_t i = 0; i < old_capacity; i++) {
+                if (old_dist[i] != 0) {
+                    place(std::move(old_slots[i]));
+                    old_slots[i].~value_type();
+                }
+            }
+            free(old_slots);
+            free(old_dist);
+        }
+
+        // put a key that is known to be absent, return its slot or capacity if a probe got too long
+        template<class V>
+        size_t place (V &&keyval) {
+            size_t mask = capacity - 1;
+            size_t i = home(keyval.first);
+            unsigned d = 1;
+            // robin hood: take the slot of the first element that is closer to its home than we are
+            while (dist[i] >= d) {
+                i = (i + 1) & mask;
+                if (++d == MAX_DIST) {
+                    rehash(capacity << 1);
+                    return place(std::forward<V>(keyval));
+                }
+            }
+            size_t j = i;
+            while (dist[j] != 0) {
+                if (dist[j] == MAX_DIST - 1) {
+                    rehash(capacity << 1);
+                    return place(std::forward<V>(keyval));
+                }
+                j = (j + 1) & mask;
+            }
+            // shift the rest of the cluster one slot to the right
+            while (j != i) {
+                size_t k = (j - 1) & mask;
+                new(&slots[j]) value_type(std::move(slots[k]));
+                slots[k].~value_type();
+                dist[j] = dist[k] + 1;
+                j = k;
+            }
+            new(&slots[i]) value_type(std::forward<V>(keyval));
+            dist[i] = d;
+            return i;
+        }
+
+        void reserve_one () {
+            // keep the load factor below 7/8
+            if ((length + 1) * 8 > capacity * 7) {
+                rehash(capacity << 1);
+            }
+        }
+
+    public:
+        unordered_map () {
+            allocate(MIN_CAPACITY);
+        }
+
+        unordered_map (const unordered_map &other) {
+            allocate(other.capacity);
+            for (size_t i = 0; i < capacity; i++) {
+                dist[i] = other.dist[i];
+                if (dist[i] != 0) {
+                    new(&slots[i]) value_type(other.slots[i]);
+                }
+            }
+            length = other.length;
+        }
+
+        unordered_map &operator= (const unordered_map &other) {
+            if (this == &other) {
+                return *this;
+            }
+            release();
+            allocate(other.capacity);
+            for (size_t i = 0; i < capacity; i++) {
+                dist[i] = other.dist[i];
+                if (dist[i] != 0) {
+                    new(&slots[i]) value_type(other.slots[i]);
+                }
+            }
+            length = other.length;
+            return *this;
+        }
+
+        ~unordered_map () {
+            release();
+        }
+
+        /**
+         * access specified element with bounds checking
+         * If no such element exists, an exception of type `index_out_of_bound'
+         */
+        Value &at (const Key &key) {
+            size_t i = locate(key);
+            if (i == capacity) {
+                throw index_out_of_bound();
+            }
+            return slots[i].second;
+        }
+
+        const Value &at (const Key &key) const {
+            size_t i = locate(key);
+            if (i == capacity) {
+                throw index_out_of_bound();
+            }
+            return slots[i].second;
+        }
+
+        /**
+         * performing an insertion if such key does not already exist.
+         */
+        Value &operator[] (const Key &key) {
+            size_t i = locate(key);
+            if (i != capacity) {
+                return slots[i].second;
+            }
+            reserve_one();
+            length++;
+            return slots[place(value_type(key , Value()))].second;
+        }
+
+        /**
+         * behave like at() throw index_out_of_bound if such key does not exist.
+         */
+        const Value &operator[] (const Key &key) const {
+            return at(key);
+        }
+
+        iterator begin () {
+            return iterator(this , next(0));
+        }
+
+        const_iterator cbegin () const {
+            return const_iterator(const_cast<unordered_map *>(this) , next(0));
+        }
+
+        iterator end () {
+            return iterator(this , capacity);
+        }
+
+        const_iterator cend () const {
+            return const_iterator(const_cast<unordered_map *>(this) , capacity);
+        }
+
+        bool empty () const {
+            return length == 0;
+        }
+
+        size_t size () const {
+            return length;
+        }
+
+        void clear () {
+            release();
+            allocate(MIN_CAPACITY);
+            length = 0;
+        }
+
+        /**
+         * insert an element.
+         * return a pair, the first of the pair is
+         *   the iterator to the new element (or the element that prevented the insertion),
+         *   the second one is true if insert successfully, or false.
+         */
+        pair<iterator , bool> insert (const value_type &keyval) {
+            size_t i = locate(keyval.first);
+            if (i != capacity) {
+                return pair<iterator , bool>(iterator(this , i) , false);
+            }
+            reserve_one();
+            length++;
+            i = place(keyval);
+            return pair<iterator , bool>(iterator(this , i) , true);
+        }
+
+        /**
+         * erase the element at pos.
+         *
+         * throw if pos pointed to a bad element (pos == this->end() || pos points an element out of this)
+         */
+        void erase (iterator pos) {
+            if (pos.Map != this || pos.index >= capacity || dist[pos.index] == 0) {
+                throw invalid_iterator();
+            }
+            size_t mask = capacity - 1;
+            size_t i = pos.index;
+            slots[i].~value_type();
+            // backward shift: pull the following displaced elements one slot closer to home
+            for (size_t j = (i + 1) & mask; dist[j] > 1; j = (j + 1) & mask) {
+                new(&slots[i]) value_type(std::move(slots[j]));
+                slots[j].~value_type();
+                dist[i] = dist[j] - 1;
+                i = j;
+            }
+            dist[i] = 0;
+            length--;
+        }
+
+        /**
+         * Returns the number of elements with key, which is either 1 or 0.
+         */
+        size_t count (const Key &key) const {
+            return locate(key) == capacity ? 0 : 1;
+        }
+
+        /**
+         * If no such element is found, past-the-end (see end()) iterator is returned.
+         */
+        iterator find (const Key &key) {
+            return iterator(this , locate(key));
+        }
+
+        const_iterator find (const Key &key) const {
+            return const_iterator(const_cast<unordered_map *>(this) , locate(key));
+        }
+    };
+
+}
+
+#endif
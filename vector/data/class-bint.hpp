@@ -7,8 +7,17 @@
 
 namespace Util {
 
-const size_t MIN_CAPACITY = 2048;
-
+// limbs stored inside the object, so magnitudes below 2^96 never touch the heap
+const size_t INLINE_LIMBS = 3;
+// operand lengths in 32 bit limbs from which operator* switches algorithm,
+// measured with benchmark/bint
+const size_t KARATSUBA_THRESHOLD = 256;
+const size_t NTT_THRESHOLD = 8192;
+
+/**
+ * a signed integer of any length: base 2^32 limbs, least significant first, with the
+ * sign apart; decimal is only produced and parsed by the string constructor and the streams.
+ */
 class Bint {
 	class NewSpaceFailed : public std::runtime_error {
 	public:
@@ -18,14 +27,40 @@ class Bint {
 	public:
 		BadCast();
 	};
+	typedef unsigned int limb;
+	// small, or the heap once more than INLINE_LIMBS are needed
+	limb *data;
+	// limbs in use: at least one, no leading zero limbs, and zero is never minus
+	unsigned int length;
+	unsigned int capacity;
+	limb small[INLINE_LIMBS];
 	bool isMinus = false;
-	size_t length;
-	int *data = nullptr;
-	size_t capacity = MIN_CAPACITY;
-	void _DoubleSpace();
-	void _SafeNewSpace(int *&p, const size_t &len);
+	void _Reserve(size_t len, bool keep = true);
+	void _Release();
+	void _Trim();
+	void _Store(const limb *p, size_t len, bool minus);
+	void _Assign(long long x);
 	explicit Bint(const size_t &capa);
+	static Bint _ParseBlock(const std::string &x, size_t start, size_t end);
+	static int _Compare(const Bint &lhs, const Bint &rhs);
+	static limb _Add(const limb *a, size_t n, const limb *b, size_t m, limb *out);
+	static void _Sub(const limb *a, size_t n, const limb *b, size_t m, limb *out);
+	static Bint _AddSigned(const Bint &lhs, const Bint &rhs, bool negate);
+	static void _MulLimbs(const limb *a, size_t n, const limb *b, size_t m, limb *out);
+	static void _Schoolbook(const unsigned long long *a, const unsigned long long *b, size_t n, size_t m,
+	                        unsigned long long *out);
+	static void _Karatsuba(const unsigned long long *a, const unsigned long long *b, size_t n,
+	                       unsigned long long *out, unsigned long long *scratch);
+	template<unsigned int MOD>
+	static void _Transform(std::vector<unsigned int> &a, bool invert);
+	static bool _Ntt(const unsigned long long *a, size_t n, const unsigned long long *b, size_t m,
+	                 unsigned long long *out);
 public:
+	/**
+	 * how a product is computed, AUTO picks by the length of the shorter operand.
+	 */
+	enum Multiplication { AUTO, SCHOOLBOOK, KARATSUBA, NTT };
+
 	Bint();
 	Bint(int x);
 	Bint(long long x);
@@ -53,6 +88,7 @@ public:
 	friend Bint operator-(Bint &&b);
 	friend Bint operator-(const Bint &lhs, const Bint &rhs);
 	friend Bint operator*(const Bint &lhs, const Bint &rhs);
+	static Bint multiply(const Bint &lhs, const Bint &rhs, Multiplication method = AUTO);
 
 	friend std::istream &operator>>(std::istream &is, Bint &b);
 	friend std::ostream &operator<<(std::ostream &os, const Bint &b);
@@ -63,166 +99,210 @@ public:
 
 #include <iomanip>
 #include <algorithm>
+#include <new>
+#include <utility>
 
 namespace Util {
 
 Bint::NewSpaceFailed::NewSpaceFailed() : std::runtime_error("No Enough Memory Space.") {}
 Bint::BadCast::BadCast() : std::invalid_argument("Cannot convert to a Bint object") {}
 
-void Bint::_SafeNewSpace(int *&p, const size_t &len)
+// room for len limbs, the first length of them kept when keep is set
+void Bint::_Reserve(size_t len, bool keep)
 {
-	if (p != nullptr) {
-		delete[] p;
-		p = nullptr;
+	if (len <= capacity) {
+		return;
 	}
-	p = new int[len];
+	size_t grown = std::max(len, static_cast<size_t>(capacity) << 1);
+	limb *p = new (std::nothrow) limb[grown];
 	if (p == nullptr) {
 		throw NewSpaceFailed();
 	}
-	memset(p, 0, len * sizeof(unsigned int));
+	if (keep) {
+		memcpy(p, data, length * sizeof(limb));
+	}
+	_Release();
+	data = p;
+	capacity = static_cast<unsigned int>(grown);
 }
 
-void Bint::_DoubleSpace()
+void Bint::_Release()
 {
-	int *newMem = nullptr;
-	_SafeNewSpace(newMem, capacity << 1);
-	memcpy(newMem, data, capacity * sizeof(int));
-	delete[] data;
-	data = newMem;
-	capacity <<= 1;
+	if (data != small) {
+		delete[] data;
+	}
+	data = small;
+	capacity = INLINE_LIMBS;
 }
 
-Bint::Bint()
-	: length(1)
+void Bint::_Trim()
 {
-	_SafeNewSpace(data, capacity);
+	while (length > 1 && data[length - 1] == 0) {
+		--length;
+	}
+	if (length == 1 && data[0] == 0) {
+		isMinus = false;
+	}
 }
 
-Bint::Bint(int x)
-	: length(0)
+// the value p[0, len) with the given sign, p may be data itself
+void Bint::_Store(const limb *p, size_t len, bool minus)
 {
-	_SafeNewSpace(data, capacity);
-	if (x < 0) {
-		isMinus = true;
-		x = -x;
+	while (len > 1 && p[len - 1] == 0) {
+		--len;
 	}
-	while (x) {
-		data[length++] = x % 10000;
-		x /= 10000;
-	}
-	if (!length) {
-		length = 1;
+	if (p != data) {
+		_Reserve(len, false);
+		memcpy(data, p, sizeof(limb) * len);
 	}
+	length = static_cast<unsigned int>(len);
+	isMinus = minus;
+	_Trim();
+}
+
+void Bint::_Assign(long long x)
+{
+	isMinus = x < 0;
+	unsigned long long magnitude = x < 0 ? 0ULL - static_cast<unsigned long long>(x) : x;
+	data[0] = static_cast<limb>(magnitude);
+	data[1] = static_cast<limb>(magnitude >> 32);
+	length = data[1] != 0 ? 2 : 1;
+}
+
+Bint::Bint()
+	: data(small), length(1), capacity(INLINE_LIMBS)
+{
+	small[0] = 0;
+}
+
+Bint::Bint(int x)
+	: data(small), length(1), capacity(INLINE_LIMBS)
+{
+	_Assign(x);
 }
 
 Bint::Bint(long long x)
-	: length(0)
+	: data(small), length(1), capacity(INLINE_LIMBS)
 {
-	_SafeNewSpace(data, capacity);
-	if (x < 0) {
-		isMinus = true;
-		x = -x;
-	}
-	while (x) {
-		data[length++] = static_cast<unsigned int>(x % 10000);
-		x /= 10000;
-	}
-	if (!length) {
-		length = 1;
-	}
+	_Assign(x);
 }
 
 Bint::Bint(const size_t &capa)
-	: length(1)
+	: data(small), length(1), capacity(INLINE_LIMBS)
 {
-	while (capacity < capa) {
-		capacity <<= 1;
-	}
-	_SafeNewSpace(data, capacity);
+	_Reserve(capa, false);
+	data[0] = 0;
 }
 
-Bint::Bint(std::string x)
+// the digits x[start, end), nine at a time: value = value * 10^9 + chunk over all limbs
+Bint Bint::_ParseBlock(const std::string &x, size_t start, size_t end)
 {
-	while (x[0] == '-') {
-		isMinus = !isMinus;
-		x.erase(0, 1);
-	}
-	while ((capacity << 2) <= x.length()) {
-		capacity <<= 1;
+	Bint part(static_cast<size_t>((end - start) / 9 + 2));
+	for (size_t i = start; i < end;) {
+		size_t next = i + ((end - i) % 9 == 0 ? 9 : (end - i) % 9);
+		unsigned long long scale = 1, carry = 0;
+		for (; i < next; ++i) {
+			scale *= 10;
+			carry = carry * 10 + (x[i] - '0');
+		}
+		for (size_t k = 0; k < part.length; ++k) {
+			carry += part.data[k] * scale;
+			part.data[k] = static_cast<limb>(carry);
+			carry >>= 32;
+		}
+		if (carry != 0) {
+			part.data[part.length++] = static_cast<limb>(carry);
+		}
 	}
+	return part;
+}
 
-	_SafeNewSpace(data, capacity);
-
-	size_t mid = x.length() >> 1;
-	for (size_t i = 0; i < mid; ++i) {
-		std::swap(x[i], x[x.length() - 1 - i]);
+// blocks of PARSE_BLOCK digits parsed directly, least significant first, then neighbours are joined
+// pairwise with the powers 10^PARSE_BLOCK, 10^(2 PARSE_BLOCK), ... so that long strings go through
+// the fast products
+Bint::Bint(std::string x)
+	: data(small), length(1), capacity(INLINE_LIMBS)
+{
+	const size_t PARSE_BLOCK = 576;
+	small[0] = 0;
+	bool minus = false;
+	size_t begin = 0;
+	while (begin < x.length() && x[begin] == '-') {
+		minus = !minus;
+		++begin;
+	}
+	if (begin == x.length()) {
+		throw BadCast();
+	}
+	for (size_t i = begin; i < x.length(); ++i) {
+		if (x[i] > '9' || x[i] < '0') {
+			throw BadCast();
+		}
 	}
-
-	const static unsigned int pow10[4] = {1, 10, 100, 1000};
-	for (size_t i = 0; i < capacity; ++i) {
-		if ((i << 2) >= x.length()) {
-			length = i;
-			break;
+	if (x.length() - begin <= PARSE_BLOCK) {
+		*this = _ParseBlock(x, begin, x.length());
+		isMinus = minus;
+		_Trim();
+		return;
+	}
+	std::vector<Bint> parts;
+	parts.reserve((x.length() - begin) / PARSE_BLOCK + 1);
+	for (size_t end = x.length(); end > begin;) {
+		size_t start = end - begin > PARSE_BLOCK ? end - PARSE_BLOCK : begin;
+		parts.push_back(_ParseBlock(x, start, end));
+		end = start;
+	}
+	Bint power = _ParseBlock("1" + std::string(PARSE_BLOCK, '0'), 0, PARSE_BLOCK + 1);
+	while (parts.size() > 1) {
+		size_t half = 0;
+		for (size_t i = 0; i + 1 < parts.size(); i += 2) {
+			parts[half++] = parts[i + 1] * power + parts[i];
 		}
-		for (size_t j = 0; j < 4; ++j) {
-			if ((i << 2) + j >= x.length()) {
-				break;
-			}
-			if (x[(i << 2) + j] > '9' || x[(i << 2) + j] < '0') {
-				throw BadCast();
-			}
-			data[i] = data[i] + (x[(i << 2) + j] - '0') * pow10[j];
+		if (parts.size() % 2) {
+			parts[half++] = std::move(parts.back());
+		}
+		parts.resize(half);
+		if (parts.size() > 1) {
+			power = power * power;
 		}
 	}
+	*this = std::move(parts[0]);
+	isMinus = minus;
+	_Trim();
 }
 
 Bint::Bint(const Bint &b)
-	: isMinus(b.isMinus), length(b.length), capacity(b.capacity)
+	: data(small), length(b.length), capacity(INLINE_LIMBS), isMinus(b.isMinus)
 {
-	_SafeNewSpace(data, capacity);
-	memcpy(data, b.data, sizeof(unsigned int) * capacity);
+	_Reserve(length, false);
+	memcpy(data, b.data, sizeof(limb) * length);
 }
 
 Bint::Bint(Bint &&b) noexcept
-	: isMinus(b.isMinus), length(b.length), capacity(b.capacity)
+	: data(small), length(b.length), capacity(INLINE_LIMBS), isMinus(b.isMinus)
 {
-	data = b.data;
-	b.data = nullptr;
+	if (b.data == b.small) {
+		memcpy(small, b.small, sizeof(limb) * length);
+	} else {
+		data = b.data;
+		capacity = b.capacity;
+		b.data = b.small;
+		b.capacity = INLINE_LIMBS;
+	}
+	b.length = 1;
+	b.small[0] = 0;
+	b.isMinus = false;
 }
 
 Bint &Bint::operator=(int x)
 {
-	memset(data, 0, sizeof(unsigned int) * capacity);
-	length = 0;
-	if (x < 0) {
-		isMinus = true;
-		x = -x;
-	}
-	while (x) {
-		data[length++] = x % 10000;
-		x /= 10000;
-	}
-	if (!length) {
-		length = 1;
-	}
+	_Assign(x);
 	return *this;
 }
 
 Bint &Bint::operator=(long long x)
 {
-	memset(data, 0, sizeof(unsigned int) * capacity);
-	length = 0;
-	if (x < 0) {
-		isMinus = true;
-		x = -x;
-	}
-	while (x) {
-		data[length++] = static_cast<unsigned int>(x % 10000);
-		x /= 10000;
-	}
-	if (!length) {
-		length = 1;
-	}
+	_Assign(x);
 	return *this;
 }
 
@@ -231,11 +311,8 @@ Bint &Bint::operator=(const Bint &rhs)
 	if (this == &rhs) {
 		return *this;
 	}
-	if (rhs.capacity > capacity) {
-		capacity = rhs.capacity;
-		_SafeNewSpace(data, capacity);
-	}
-	memcpy(data, rhs.data, sizeof(unsigned int) * rhs.capacity);
+	_Reserve(rhs.length, false);
+	memcpy(data, rhs.data, sizeof(limb) * rhs.length);
 	length = rhs.length;
 	isMinus = rhs.isMinus;
 	return *this;
@@ -246,11 +323,21 @@ Bint &Bint::operator=(Bint &&rhs) noexcept
 	if (this == &rhs) {
 		return *this;
 	}
-	capacity = rhs.capacity;
+	if (rhs.data == rhs.small) {
+		// never more limbs than fit inline, so no allocation
+		memcpy(data, rhs.small, sizeof(limb) * rhs.length);
+	} else {
+		_Release();
+		data = rhs.data;
+		capacity = rhs.capacity;
+		rhs.data = rhs.small;
+		rhs.capacity = INLINE_LIMBS;
+	}
 	length = rhs.length;
 	isMinus = rhs.isMinus;
-	data = rhs.data;
-	rhs.data = nullptr;
+	rhs.length = 1;
+	rhs.small[0] = 0;
+	rhs.isMinus = false;
 	return *this;
 }
 
@@ -262,18 +349,37 @@ std::istream &operator>>(std::istream &is, Bint &b)
 	return is;
 }
 
+// base 10^9 chunks by repeated division, quadratic in the length but only needed for output
 std::ostream &operator<<(std::ostream &os, const Bint &b)
 {
-	if (b.data == nullptr) {
+	if (b.isMinus) {
+		os << "-";
+	}
+	if (b.length <= 2) {
+		os << (static_cast<unsigned long long>(b.length == 2 ? b.data[1] : 0) << 32 | b.data[0]);
 		return os;
 	}
-	if (b.isMinus && (b.length > 1 || b.data[0] != 0)) {
-		os << "-";
+	std::vector<Bint::limb> rest(b.data, b.data + b.length);
+	std::vector<unsigned int> chunks;
+	size_t n = rest.size();
+	while (n > 0) {
+		unsigned long long remainder = 0;
+		for (size_t i = n; i-- > 0;) {
+			unsigned long long current = remainder << 32 | rest[i];
+			rest[i] = static_cast<Bint::limb>(current / 1000000000);
+			remainder = current % 1000000000;
+		}
+		chunks.push_back(static_cast<unsigned int>(remainder));
+		while (n > 0 && rest[n - 1] == 0) {
+			--n;
+		}
 	}
-	os << b.data[b.length - 1];
-	for (long long i = b.length - 2LL; i >= 0; --i) {
-		os << std::setw(4) << std::setfill('0') << b.data[i];
+	char fill = os.fill('0');
+	os << chunks.back();
+	for (size_t i = chunks.size() - 1; i-- > 0;) {
+		os << std::setw(9) << chunks[i];
 	}
+	os.fill(fill);
 	return os;
 }
 
@@ -287,67 +393,41 @@ Bint abs(const Bint &b)
 Bint abs(Bint &&b)
 {
 	b.isMinus = false;
-	return b;
+	return std::move(b);
 }
 
-bool operator==(const Bint &lhs, const Bint &rhs)
+// of the magnitudes: negative, zero or positive
+int Bint::_Compare(const Bint &lhs, const Bint &rhs)
 {
-	if (lhs.isMinus != rhs.isMinus) {
-		return false;
-	}
 	if (lhs.length != rhs.length) {
-		return false;
+		return lhs.length < rhs.length ? -1 : 1;
 	}
-	for (size_t i = 0; i < lhs.length; ++i) {
+	for (size_t i = lhs.length; i-- > 0;) {
 		if (lhs.data[i] != rhs.data[i]) {
-			return false;
+			return lhs.data[i] < rhs.data[i] ? -1 : 1;
 		}
 	}
-	return true;
+	return 0;
+}
+
+bool operator==(const Bint &lhs, const Bint &rhs)
+{
+	return lhs.isMinus == rhs.isMinus && lhs.length == rhs.length &&
+	       memcmp(lhs.data, rhs.data, sizeof(Bint::limb) * lhs.length) == 0;
 }
 
 bool operator!=(const Bint &lhs, const Bint &rhs)
 {
-	if (lhs.isMinus != rhs.isMinus) {
-		return true;
-	}
-	if (lhs.length != rhs.length) {
-		return true;
-	}
-	for (size_t i = 0; i < lhs.length; ++i) {
-		if (lhs.data[i] != rhs.data[i]) {
-			return true;
-		}
-	}
-	return false;
+	return !(lhs == rhs);
 }
 
 bool operator<(const Bint &lhs, const Bint &rhs)
 {
 	if (lhs.isMinus != rhs.isMinus) {
-		return !lhs.isMinus;
-	}
-	if (lhs.isMinus) {
-		if (lhs.length != rhs.length) {
-			return lhs.length > rhs.length;
-		}
-		for (long long i = lhs.length - 1; i >= 0; --i) {
-			if (lhs.data[i] != rhs.data[i]) {
-				return lhs.data[i] > rhs.data[i];
-			}
-		}
-		return false;
-	} else {
-		if (lhs.length != rhs.length) {
-			return lhs.length < rhs.length;
-		}
-		for (long long i = lhs.length - 1; i >= 0; --i) {
-			if (lhs.data[i] != rhs.data[i]) {
-				return lhs.data[i] < rhs.data[i];
-			}
-		}
-		return false;
+		return lhs.isMinus;
 	}
+	int order = Bint::_Compare(lhs, rhs);
+	return lhs.isMinus ? order > 0 : order < 0;
 }
 
 bool operator>(const Bint &lhs, const Bint &rhs)
@@ -357,160 +437,394 @@ bool operator>(const Bint &lhs, const Bint &rhs)
 
 bool operator<=(const Bint &lhs, const Bint &rhs)
 {
-	if (lhs.isMinus != rhs.isMinus) {
-		return !lhs.isMinus;
-	}
-	if (lhs.isMinus) {
-		if (lhs.length != rhs.length) {
-			return lhs.length > rhs.length;
-		}
-		for (long long i = lhs.length - 1; i >= 0; --i) {
-			if (lhs.data[i] != rhs.data[i]) {
-				return lhs.data[i] > rhs.data[i];
-			}
+	return !(rhs < lhs);
+}
+
+bool operator>=(const Bint &lhs, const Bint &rhs)
+{
+	return !(lhs < rhs);
+}
+
+// out[0, n) = a + b with n >= m, returns the carry out of the top limb.
+// a 64 bit word holds two limbs, so the carry chain is half as long as it is per limb.
+// with AVX-512 the compiler vectorizes a carry lookahead instead: 64 limb sums, which of them
+// generate a carry and which pass one on go into two bit masks, and a single 64 bit addition
+// of those masks yields the carry into every limb of the block
+Bint::limb Bint::_Add(const limb *a, size_t n, const limb *b, size_t m, limb *out)
+{
+	unsigned long long carry = 0;
+	size_t i = 0;
+#if defined(__AVX512BW__) && defined(__AVX512VL__)
+	for (; i + 64 <= m; i += 64) {
+		limb sum[64];
+		unsigned char generates[64], propagates[64];
+		for (size_t k = 0; k < 64; ++k) {
+			sum[k] = a[i + k] + b[i + k];
+			generates[k] = sum[k] < a[i + k];
+			propagates[k] = sum[k] == 0xFFFFFFFFU;
 		}
-		return true;
-	} else {
-		if (lhs.length != rhs.length) {
-			return lhs.length < rhs.length;
+		unsigned long long generate = 0, propagate = 0;
+		for (size_t k = 0; k < 64; ++k) {
+			generate |= static_cast<unsigned long long>(generates[k]) << k;
+			propagate |= static_cast<unsigned long long>(propagates[k]) << k;
 		}
-		for (long long i = lhs.length - 1; i >= 0; --i) {
-			if (lhs.data[i] != rhs.data[i]) {
-				return lhs.data[i] < rhs.data[i];
-			}
+		unsigned long long either = generate | propagate, partial = either + generate, total = partial + carry;
+		unsigned long long incoming = total ^ propagate;
+		carry = (partial < either) | (total < partial);
+		for (size_t k = 0; k < 64; ++k) {
+			out[i + k] = sum[k] + static_cast<limb>(incoming >> k & 1);
 		}
-		return true;
 	}
+#endif
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+	for (; i + 2 <= m; i += 2) {
+		unsigned long long x, y;
+		memcpy(&x, a + i, sizeof(x));
+		memcpy(&y, b + i, sizeof(y));
+		unsigned long long partial = x + y, total = partial + carry;
+		carry = (partial < x) | (total < partial);
+		memcpy(out + i, &total, sizeof(total));
+	}
+#endif
+	for (; i < m; ++i) {
+		carry += static_cast<unsigned long long>(a[i]) + b[i];
+		out[i] = static_cast<limb>(carry);
+		carry >>= 32;
+	}
+	for (; i < n; ++i) {
+		carry += a[i];
+		out[i] = static_cast<limb>(carry);
+		carry >>= 32;
+	}
+	return static_cast<limb>(carry);
 }
 
-bool operator>=(const Bint &lhs, const Bint &rhs)
+// out[0, n) = a - b where a >= b, the same two paths as _Add with borrows for carries:
+// a limb generates a borrow when a < b and passes one on when it subtracted to zero
+void Bint::_Sub(const limb *a, size_t n, const limb *b, size_t m, limb *out)
 {
-	if (lhs.isMinus != rhs.isMinus) {
-		return lhs.isMinus;
-	}
-	if (lhs.isMinus) {
-		if (lhs.length != rhs.length) {
-			return lhs.length < rhs.length;
+	unsigned long long borrow = 0;
+	size_t i = 0;
+#if defined(__AVX512BW__) && defined(__AVX512VL__)
+	for (; i + 64 <= m; i += 64) {
+		limb difference[64];
+		unsigned char generates[64], propagates[64];
+		for (size_t k = 0; k < 64; ++k) {
+			difference[k] = a[i + k] - b[i + k];
+			generates[k] = a[i + k] < b[i + k];
+			propagates[k] = difference[k] == 0;
 		}
-		for (long long i = lhs.length - 1; i >= 0; --i) {
-			if (lhs.data[i] != rhs.data[i]) {
-				return lhs.data[i] < rhs.data[i];
-			}
+		unsigned long long generate = 0, propagate = 0;
+		for (size_t k = 0; k < 64; ++k) {
+			generate |= static_cast<unsigned long long>(generates[k]) << k;
+			propagate |= static_cast<unsigned long long>(propagates[k]) << k;
 		}
-		return true;
-	} else {
-		if (lhs.length != rhs.length) {
-			return lhs.length > rhs.length;
+		unsigned long long either = generate | propagate, partial = either + generate, total = partial + borrow;
+		unsigned long long incoming = total ^ propagate;
+		borrow = (partial < either) | (total < partial);
+		for (size_t k = 0; k < 64; ++k) {
+			out[i + k] = difference[k] - static_cast<limb>(incoming >> k & 1);
 		}
-		for (long long i = lhs.length - 1; i >= 0; --i) {
-			if (lhs.data[i] != rhs.data[i]) {
-				return lhs.data[i] > rhs.data[i];
-			}
-		}
-		return true;
+	}
+#endif
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+	for (; i + 2 <= m; i += 2) {
+		unsigned long long x, y;
+		memcpy(&x, a + i, sizeof(x));
+		memcpy(&y, b + i, sizeof(y));
+		unsigned long long partial = x - y, total = partial - borrow;
+		borrow = (x < y) | (partial < borrow);
+		memcpy(out + i, &total, sizeof(total));
+	}
+#endif
+	for (; i < m; ++i) {
+		unsigned long long difference = static_cast<unsigned long long>(a[i]) - b[i] - borrow;
+		out[i] = static_cast<limb>(difference);
+		borrow = difference >> 63;
+	}
+	for (; i < n; ++i) {
+		unsigned long long difference = static_cast<unsigned long long>(a[i]) - borrow;
+		out[i] = static_cast<limb>(difference);
+		borrow = difference >> 63;
 	}
 }
 
-
-Bint operator+(const Bint &lhs, const Bint &rhs)
+// lhs + rhs, or lhs - rhs when negate is set.
+// a result that may still fit inline is computed on the stack, so it is not allocated for the carry limb
+Bint Bint::_AddSigned(const Bint &lhs, const Bint &rhs, bool negate)
 {
-	if (lhs.isMinus == rhs.isMinus) {
-		size_t maxLen = std::max(lhs.length, rhs.length);
-		size_t expectLen = maxLen + 1;
-		Bint result(expectLen); // special constructor
-		for (size_t i = 0; i < maxLen; ++i) {
-			result.data[i] = lhs.data[i] + rhs.data[i];
-		}
-		for (size_t i = 0; i < maxLen; ++i) {
-			if (result.data[i] > 10000) {
-				result.data[i] -= 10000;
-				++result.data[i + 1];
-			}
+	bool rhsMinus = rhs.isMinus != negate, minus;
+	const Bint *a = &lhs, *b = &rhs;
+	size_t len = std::max(lhs.length, rhs.length) + 1;
+	limb buffer[2 * INLINE_LIMBS];
+	Bint result(len <= 2 * INLINE_LIMBS ? INLINE_LIMBS : len);
+	limb *out = len <= 2 * INLINE_LIMBS ? buffer : result.data;
+	if (lhs.isMinus == rhsMinus) {
+		if (a->length < b->length) {
+			std::swap(a, b);
 		}
-		result.length = result.data[maxLen] > 0 ? maxLen + 1 : maxLen;
-		result.isMinus = lhs.isMinus;
-		return result;
+		out[a->length] = _Add(a->data, a->length, b->data, b->length, out);
+		len = a->length + 1;
+		minus = lhs.isMinus;
 	} else {
-		if (lhs.isMinus) {
-			return rhs - abs(lhs);
+		if (_Compare(lhs, rhs) < 0) {
+			std::swap(a, b);
+			minus = rhsMinus;
 		} else {
-			return lhs - abs(rhs);
+			minus = lhs.isMinus;
 		}
+		_Sub(a->data, a->length, b->data, b->length, out);
+		len = a->length;
 	}
+	result._Store(out, len, minus);
+	return result;
+}
+
+Bint operator+(const Bint &lhs, const Bint &rhs)
+{
+	return Bint::_AddSigned(lhs, rhs, false);
 }
 
 Bint operator-(const Bint &b)
 {
 	Bint result(b);
 	result.isMinus = !result.isMinus;
+	result._Trim();
 	return result;
 }
 
 Bint operator-(Bint &&b)
 {
 	b.isMinus = !b.isMinus;
-	return b;
+	b._Trim();
+	return std::move(b);
 }
 
 Bint operator-(const Bint &lhs, const Bint &rhs)
 {
-	if (lhs.isMinus == rhs.isMinus) {
-		if (lhs.isMinus) {
-			return -(abs(lhs) - abs(rhs));
-		} else {
-			if (lhs < rhs) {
-				return -(rhs - lhs);
-			}
-			Bint result(std::max(lhs.length, rhs.length));
-			for (size_t i = 0; i < lhs.length; ++i) {
-				result.data[i] = lhs.data[i] - rhs.data[i];
-			}
-			for (size_t i = 0; i < lhs.length; ++i) {
-				if (result.data[i] < 0) {
-					result.data[i] += 10000;
-					++result.data[i + 1];
-				}
+	return Bint::_AddSigned(lhs, rhs, true);
+}
+
+// out[0, n + m) = a * b on limbs, a limb product plus two limbs still fits in 64 bits
+void Bint::_MulLimbs(const limb *a, size_t n, const limb *b, size_t m, limb *out)
+{
+	std::fill(out, out + n + m, 0U);
+	for (size_t i = 0; i < n; ++i) {
+		unsigned long long x = a[i], carry = 0;
+		for (size_t j = 0; j < m; ++j) {
+			carry += x * b[j] + out[i + j];
+			out[i + j] = static_cast<limb>(carry);
+			carry >>= 32;
+		}
+		out[i + m] = static_cast<limb>(carry);
+	}
+}
+
+// out[0, n + m - 1) += a * b as polynomials, carries are left to the caller
+void Bint::_Schoolbook(const unsigned long long *a, const unsigned long long *b, size_t n, size_t m,
+                       unsigned long long *out)
+{
+	for (size_t i = 0; i < n; ++i) {
+		unsigned long long x = a[i];
+		for (size_t j = 0; j < m; ++j) {
+			out[i + j] += x * b[j];
+		}
+	}
+}
+
+// out[0, 2n) = a * b as polynomials, a and b both have n coefficients; scratch needs 4n + 256.
+// the sums a0 + a1 grow with the depth and may wrap, but only +, - and * are used, so every
+// coefficient is right modulo 2^64 and the final ones are below 2^64
+void Bint::_Karatsuba(const unsigned long long *a, const unsigned long long *b, size_t n,
+                      unsigned long long *out, unsigned long long *scratch)
+{
+	// digits, not limbs
+	const size_t BASE = 32;
+	if (n < BASE) {
+		std::fill(out, out + 2 * n, 0ULL);
+		_Schoolbook(a, b, n, n, out);
+		return;
+	}
+	size_t low = n >> 1, high = n - low;
+	unsigned long long *sa = scratch, *sb = scratch + high, *middle = scratch + 2 * high;
+	_Karatsuba(a, b, low, out, scratch + 4 * high);
+	_Karatsuba(a + low, b + low, high, out + 2 * low, scratch + 4 * high);
+	for (size_t i = 0; i < high; ++i) {
+		sa[i] = a[low + i] + (i < low ? a[i] : 0);
+		sb[i] = b[low + i] + (i < low ? b[i] : 0);
+	}
+	_Karatsuba(sa, sb, high, middle, scratch + 4 * high);
+	for (size_t i = 0; i < 2 * low; ++i) {
+		middle[i] -= out[i];
+	}
+	for (size_t i = 0; i < 2 * high; ++i) {
+		middle[i] -= out[2 * low + i];
+	}
+	for (size_t i = 0; i < 2 * high; ++i) {
+		out[low + i] += middle[i];
+	}
+}
+
+template<unsigned int MOD>
+void Bint::_Transform(std::vector<unsigned int> &a, bool invert)
+{
+	const unsigned int ROOT = 3;
+	size_t n = a.size();
+	for (size_t i = 1, j = 0; i < n; ++i) {
+		size_t bit = n >> 1;
+		for (; j & bit; bit >>= 1) {
+			j ^= bit;
+		}
+		j ^= bit;
+		if (i < j) {
+			std::swap(a[i], a[j]);
+		}
+	}
+	auto power = [](unsigned long long x, unsigned long long e) {
+		unsigned long long r = 1;
+		for (; e; e >>= 1, x = x * x % MOD) {
+			if (e & 1) {
+				r = r * x % MOD;
 			}
-			while (result.length > 1 && result.data[result.length - 1] == 0) {
-				--result.length;
+		}
+		return r;
+	};
+	std::vector<unsigned int> roots(n >> 1);
+	for (size_t len = 2; len <= n; len <<= 1) {
+		unsigned long long w = power(ROOT, (MOD - 1) / len);
+		if (invert) {
+			w = power(w, MOD - 2);
+		}
+		size_t half = len >> 1;
+		roots[0] = 1;
+		for (size_t k = 1; k < half; ++k) {
+			roots[k] = static_cast<unsigned int>(roots[k - 1] * w % MOD);
+		}
+		for (size_t i = 0; i < n; i += len) {
+			for (size_t k = 0; k < half; ++k) {
+				unsigned int u = a[i + k];
+				unsigned int v = static_cast<unsigned int>(static_cast<unsigned long long>(a[i + k + half]) * roots[k] % MOD);
+				a[i + k] = u + v >= MOD ? u + v - MOD : u + v;
+				a[i + k + half] = u >= v ? u - v : u + MOD - v;
 			}
-			return result;
 		}
-	} else {
-		return lhs + (-rhs);
+	}
+	if (invert) {
+		unsigned long long inverse = power(n, MOD - 2);
+		for (size_t i = 0; i < n; ++i) {
+			a[i] = static_cast<unsigned int>(a[i] * inverse % MOD);
+		}
 	}
 }
 
-Bint operator*(const Bint &lhs, const Bint &rhs)
+// out[0, n + m - 1) = a * b as polynomials through two number theoretic transforms joined by the CRT.
+// the coefficients are 16 bit digits, so a product coefficient is at most min(n, m) * 65535^2, below
+// the product of the primes for any length the transforms reach (2^23); false when longer than that
+bool Bint::_Ntt(const unsigned long long *a, size_t n, const unsigned long long *b, size_t m,
+                unsigned long long *out)
 {
-	size_t expectLen = lhs.length + rhs.length + 2;
-	Bint result(expectLen);
-	for (size_t i = 0; i < lhs.length; ++i) {
-		for (size_t j = 0; j < rhs.length; ++j) {
-			long long tmp = result.data[i + j] + static_cast<long long>(lhs.data[i]) * rhs.data[j];
-			if (tmp >= 10000) {
-				result.data[i + j] = tmp % 10000;
-				result.data[i + j + 1] += static_cast<int>(tmp / 10000);
-			} else {
-				result.data[i + j] = tmp;
-			}
+	const unsigned int P1 = 998244353, P2 = 469762049;
+	size_t size = 1;
+	while (size < n + m - 1) {
+		size <<= 1;
+	}
+	if (size > (1U << 23)) {
+		return false;
+	}
+	std::vector<unsigned int> x1(a, a + n), y1(b, b + m);
+	x1.resize(size, 0);
+	y1.resize(size, 0);
+	std::vector<unsigned int> x2(x1), y2(y1);
+	_Transform<P1>(x1, false);
+	_Transform<P1>(y1, false);
+	_Transform<P2>(x2, false);
+	_Transform<P2>(y2, false);
+	for (size_t i = 0; i < size; ++i) {
+		x1[i] = static_cast<unsigned int>(static_cast<unsigned long long>(x1[i]) * y1[i] % P1);
+		x2[i] = static_cast<unsigned int>(static_cast<unsigned long long>(x2[i]) * y2[i] % P2);
+	}
+	_Transform<P1>(x1, true);
+	_Transform<P2>(x2, true);
+	// P1^-1 mod P2
+	unsigned long long inverse = 1, base = P1 % P2;
+	for (unsigned int e = P2 - 2; e; e >>= 1, base = base * base % P2) {
+		if (e & 1) {
+			inverse = inverse * base % P2;
 		}
 	}
-	result.length = lhs.length + rhs.length -1;
-	while (result.data[result.length] > 0) {
-		++result.length;
+	for (size_t i = 0; i + 1 < n + m; ++i) {
+		unsigned long long r1 = x1[i], r2 = x2[i];
+		unsigned long long t = (r2 + P2 - r1 % P2) % P2 * inverse % P2;
+		out[i] = r1 + t * P1;
 	}
-	while (result.length > 1 && result.data[result.length - 1] == 0) {
-		--result.length;
+	return true;
+}
+
+// short operands multiply limb by limb; Karatsuba and the NTT work on polynomials of 16 bit
+// digits, whose coefficients stay below 2^64, and the carries are propagated once at the end
+Bint Bint::multiply(const Bint &lhs, const Bint &rhs, Multiplication method)
+{
+	const Bint &a = lhs.length >= rhs.length ? lhs : rhs;
+	const Bint &b = lhs.length >= rhs.length ? rhs : lhs;
+	size_t n = a.length, m = b.length;
+	if (method == AUTO) {
+		method = m < KARATSUBA_THRESHOLD ? SCHOOLBOOK : m < NTT_THRESHOLD ? KARATSUBA : NTT;
+	}
+	if (method == SCHOOLBOOK && n + m <= 2 * INLINE_LIMBS) {
+		// on the stack first, like _AddSigned
+		limb buffer[2 * INLINE_LIMBS];
+		_MulLimbs(a.data, n, b.data, m, buffer);
+		Bint result;
+		result._Store(buffer, n + m, lhs.isMinus != rhs.isMinus);
+		return result;
 	}
+	Bint result(n + m);
+	if (method == SCHOOLBOOK) {
+		_MulLimbs(a.data, n, b.data, m, result.data);
+	} else {
+		std::vector<unsigned long long> x(2 * n), y(2 * m), product(2 * (n + m), 0);
+		for (size_t i = 0; i < n; ++i) {
+			x[2 * i] = a.data[i] & 0xFFFF;
+			x[2 * i + 1] = a.data[i] >> 16;
+		}
+		for (size_t i = 0; i < m; ++i) {
+			y[2 * i] = b.data[i] & 0xFFFF;
+			y[2 * i + 1] = b.data[i] >> 16;
+		}
+		if (method != NTT || !_Ntt(x.data(), 2 * n, y.data(), 2 * m, product.data())) {
+			// the longer operand in pieces as long as the shorter one
+			size_t len = 2 * m;
+			std::vector<unsigned long long> piece(len), part(2 * len), scratch(4 * len + 256);
+			for (size_t offset = 0; offset < 2 * n; offset += len) {
+				size_t used = std::min(len, 2 * n - offset);
+				std::fill(std::copy(x.begin() + offset, x.begin() + offset + used, piece.begin()), piece.end(), 0ULL);
+				_Karatsuba(piece.data(), y.data(), len, part.data(), scratch.data());
+				for (size_t i = 0; i + 1 < used + len; ++i) {
+					product[offset + i] += part[i];
+				}
+			}
+		}
+		unsigned long long carry = 0;
+		for (size_t i = 0; i < n + m; ++i) {
+			carry += product[2 * i];
+			limb low = static_cast<limb>(carry & 0xFFFF);
+			carry >>= 16;
+			carry += product[2 * i + 1];
+			result.data[i] = low | static_cast<limb>(carry & 0xFFFF) << 16;
+			carry >>= 16;
+		}
+	}
+	result._Store(result.data, n + m, lhs.isMinus != rhs.isMinus);
 	return result;
 }
 
+Bint operator*(const Bint &lhs, const Bint &rhs)
+{
+	return Bint::multiply(lhs, rhs);
+}
+
 Bint::~Bint()
 {
-	if (data != nullptr) {
-		delete[] data;
-		data = nullptr;
-	}
+	_Release();
 }
 }
@@ -0,0 +1,28 @@
+// vector: element access, iteration and appends within capacity must not allocate, checked with the allocation counter
+
+#include <cstdio>
+#include "../../vector.hpp"
+#include "../alloc-counter.hpp"
+
+int main () {
+	sjtu::vector<int> v(2048);
+	for (int i = 0; i < 1000; i++) {
+		v.push_back(i);
+	}
+	const sjtu::vector<int> &c = v;
+	long long sum = 0;
+	EXPECT_NO_ALLOC("operator[]", for (int i = 0; i < 1000; i++) sum += v[i]);
+	EXPECT_NO_ALLOC("const operator[]", for (int i = 0; i < 1000; i++) sum += c[i]);
+	EXPECT_NO_ALLOC("at", for (int i = 0; i < 1000; i++) sum += v.at(i));
+	EXPECT_NO_ALLOC("front back", sum += c.front() + c.back());
+	EXPECT_NO_ALLOC("iterate", for (auto it = v.begin(); it != v.end(); ++it) sum += *it);
+	EXPECT_NO_ALLOC("push_back within capacity", for (int i = 0; i < 1000; i++) v.push_back(i));
+	EXPECT_NO_ALLOC("insert within capacity", v.insert(v.begin() + 10, 7));
+	EXPECT_NO_ALLOC("erase", v.erase(v.begin() + 10));
+	EXPECT_NO_ALLOC("pop_back", for (int i = 0; i < 1000; i++) v.pop_back());
+	printf("%lld\n", sum);
+
+	// the counter itself: growing past the capacity allocates once per doubling
+	printf("grow: %lld\n", alloc_counter::count([&] { for (int i = 0; i < 7000; i++) v.push_back(i); }));
+	return 0;
+}
@@ -0,0 +1,75 @@
+// vector: the count_stats policy against what push_back / copy / assignment must have done
+
+#include <iostream>
+#include <cstdio>
+#include <type_traits>
+#include <utility>
+#include "../../vector.hpp"
+
+template<class V>
+void print (const char *name, const V &v) {
+	sjtu::container_stats s = v.stats();
+	printf("%s: allocations %llu deallocations %llu bytes %llu freed %llu reallocations %llu copies %llu\n", name,
+	       s.allocations, s.deallocations, s.bytes_allocated, s.bytes_freed, s.reallocations, s.copies);
+}
+
+// memory_usage() against the bytes the counting policy saw allocated
+template<class C>
+void footprint (const char *name, const C &c) {
+	sjtu::container_stats s = c.stats();
+	sjtu::container_memory m = c.memory_usage();
+	printf("%s memory: payload %d consistent %d\n", name, (int) m.payload,
+	       (int) (s.bytes_allocated - s.bytes_freed + sizeof(C) == m.total()));
+}
+
+// the default policy is an empty base: counting adds exactly the counters, no_stats adds nothing
+static_assert(std::is_empty<sjtu::no_stats>::value, "no_stats must be an empty base");
+static_assert(sizeof(sjtu::vector<int, sjtu::count_stats>) ==
+              sizeof(sjtu::vector<int>) + sizeof(sjtu::container_stats),
+              "the stats policy base must not add padding");
+
+int main () {
+	sjtu::vector<int> plain;
+	for (int i = 0; i < 1000; i++) {
+		plain.push_back(i);
+	}
+	print("plain", plain);
+
+	sjtu::vector<int, sjtu::count_stats> v;
+	for (int i = 0; i < 100; i++) {
+		v.push_back(i);
+	}
+	print("push_back", v);
+	for (int i = 0; i < 100; i++) {
+		v.insert(v.begin() + i, i);
+	}
+	print("insert", v);
+	sjtu::vector<int, sjtu::count_stats> copy(v);
+	print("copy", copy);
+	copy = v;
+	print("assign", copy);
+	long long sum = 0;
+	for (int i = 0; i < (int) v.size(); i++) {
+		sum += v[i];
+	}
+	printf("%lld\n", sum);
+	print("read", v);
+	footprint("v", v);
+	footprint("copy", copy);
+	v.pop_back();
+	footprint("pop_back", v);
+
+	// vector has no move constructor or assignment: an rvalue takes the copy paths and both sides must add up
+	sjtu::vector<int, sjtu::count_stats> moved(std::move(copy));
+	footprint("moved", moved);
+	footprint("moved from", copy);
+	for (int i = 0; i < 1000; i++) {
+		moved.push_back(i);
+	}
+	copy = std::move(moved);
+	footprint("move assigned", copy);
+	footprint("move assigned from", moved);
+	sjtu::container_memory m = plain.memory_usage();
+	printf("plain memory: %d %d\n", (int) m.payload, (int) (m.overhead - sizeof(plain)));
+	return 0;
+}
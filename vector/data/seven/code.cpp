@@ -0,0 +1,62 @@
+// Diamond::Matrix: the tiled operator* and the threaded Multiply against the i-j-k loop, kept in a sjtu::vector
+
+#include <iostream>
+#include <cstdio>
+#include "class-matrix.hpp"
+#include "../../vector.hpp"
+
+unsigned long long seed = 20190401;
+
+template<class T>
+Diamond::Matrix<T> random_matrix (size_t n, size_t m) {
+	Diamond::Matrix<T> a(n, m);
+	for (size_t i = 0; i < n; i++) {
+		for (size_t j = 0; j < m; j++) {
+			seed = seed * 6364136223846793005ULL + 1442695040888963407ULL;
+			a[i][j] = (T) ((seed >> 33) % 2001) / (T) 8 - (T) 125;
+		}
+	}
+	return a;
+}
+
+template<class T>
+Diamond::Matrix<T> ijk (const Diamond::Matrix<T> &a, const Diamond::Matrix<T> &b) {
+	Diamond::Matrix<T> c(a.RowSize(), b.ColSize(), 0);
+	for (size_t i = 0; i < a.RowSize(); ++i) {
+		for (size_t j = 0; j < b.ColSize(); ++j) {
+			for (size_t k = 0; k < a.ColSize(); ++k) {
+				c[i][j] += a[i][k] * b[k][j];
+			}
+		}
+	}
+	return c;
+}
+
+// shapes that leave partial tiles and panels, and ones longer than a cache block
+template<class T>
+void check (const char *name) {
+	const size_t shapes[][3] = {{1, 1, 1}, {3, 5, 7}, {4, 16, 16}, {17, 9, 33}, {64, 64, 64}, {70, 300, 530},
+	                            {257, 129, 65}};
+	sjtu::vector<Diamond::Matrix<T>> products;
+	for (auto &s : shapes) {
+		Diamond::Matrix<T> a = random_matrix<T>(s[0], s[1]), b = random_matrix<T>(s[1], s[2]);
+		Diamond::Matrix<T> c = ijk(a, b);
+		products.push_back(a * b);
+		printf("%s %dx%dx%d: operator* %d Multiply %d\n", name, (int) s[0], (int) s[1], (int) s[2],
+		       (int) (products.back() == c), (int) (Diamond::Multiply(a, b, 4) == c));
+	}
+	std::cout << products[1];
+}
+
+int main () {
+	check<double>("double");
+	check<float>("float");
+	check<long long>("long long");
+	Diamond::Matrix<double> a(2, 3);
+	try {
+		Diamond::Matrix<double> c = a * a;
+	} catch (std::invalid_argument &e) {
+		std::cout << e.what() << std::endl;
+	}
+	return 0;
+}
@@ -0,0 +1,49 @@
+// Util::Bint: schoolbook, Karatsuba and NTT products must agree, kept in a sjtu::vector
+
+#include <iostream>
+#include <cstdio>
+#include <string>
+#include "class-bint.hpp"
+#include "../../vector.hpp"
+
+unsigned long long seed = 20190401;
+
+std::string digits (size_t n) {
+	std::string s;
+	for (size_t i = 0; i < n; i++) {
+		seed = seed * 6364136223846793005ULL + 1442695040888963407ULL;
+		int d = (int) ((seed >> 33) % 10);
+		s += (char) ('0' + (i == 0 && d == 0 ? 1 : d));
+	}
+	return s;
+}
+
+int main () {
+	const size_t lengths[] = {1, 7, 127, 128, 129, 4000, 40000};
+	sjtu::vector<Util::Bint> products;
+	for (size_t la : lengths) {
+		for (size_t lb : lengths) {
+			if (la * lb > 20000000) {
+				continue;
+			}
+			Util::Bint a(digits(la)), b((la + lb) % 2 ? "-" + digits(lb) : digits(lb));
+			Util::Bint x = Util::Bint::multiply(a, b, Util::Bint::SCHOOLBOOK);
+			Util::Bint y = Util::Bint::multiply(a, b, Util::Bint::KARATSUBA);
+			Util::Bint z = Util::Bint::multiply(a, b, Util::Bint::NTT);
+			printf("%d x %d: karatsuba %d ntt %d operator* %d\n", (int) la, (int) lb, (int) (x == y), (int) (x == z),
+			       (int) (x == a * b));
+			if (la + lb < 140) {
+				std::cout << a << " * " << b << " = " << x << std::endl;
+			}
+			products.push_back(z);
+		}
+	}
+	// every limb a 9999, the largest coefficients there are
+	Util::Bint nines(std::string(20000, '9'));
+	std::cout << (Util::Bint::multiply(nines, nines, Util::Bint::NTT) ==
+	              Util::Bint::multiply(nines, nines, Util::Bint::KARATSUBA)) << std::endl;
+	std::cout << Util::Bint(0) * Util::Bint(-5) << " " << Util::Bint(-3) * Util::Bint(7) << " "
+	          << Util::Bint(-3) * Util::Bint(-7) << std::endl;
+	std::cout << products.size() << std::endl;
+	return 0;
+}
@@ -0,0 +1,90 @@
+#ifndef SJTU_STATS_HPP
+#define SJTU_STATS_HPP
+
+#include <cstddef>
+
+namespace sjtu {
+
+/**
+ * a snapshot of what a container has done since it was constructed.
+ * a counter stays 0 if the container never does that kind of work.
+ */
+struct container_stats {
+	unsigned long long allocations = 0;
+	unsigned long long deallocations = 0;
+	// bytes also follow storage handed from one container to another, so allocated - freed stays what is held
+	unsigned long long bytes_allocated = 0;
+	unsigned long long bytes_freed = 0;
+	// storage grown by copying to a bigger buffer, and the elements copied while doing so
+	unsigned long long reallocations = 0;
+	unsigned long long copies = 0;
+	// map: rotations and color flips while rebalancing
+	unsigned long long rotations = 0;
+	unsigned long long color_flips = 0;
+	// deque: blocks split, blocks merged, and rebalancing passes over a block
+	unsigned long long splits = 0;
+	unsigned long long merges = 0;
+	unsigned long long maintains = 0;
+};
+
+/**
+ * the bytes a container holds: payload is sizeof(T) for every element, overhead is the rest of what
+ * it allocated plus the container object itself. heap memory owned by the elements is not included.
+ */
+struct container_memory {
+	size_t payload = 0;
+	size_t overhead = 0;
+	size_t total() const { return payload + overhead; }
+};
+
+/**
+ * the default stats policy: every hook is empty and the policy is an empty base,
+ * so a container built with it is as fast and as small as one without any hooks.
+ */
+struct no_stats {
+	void on_allocate(size_t) {}
+	void on_deallocate(size_t) {}
+	void on_reallocate(size_t) {}
+	void on_give(size_t) {}
+	void on_take(size_t) {}
+	void on_rotate() {}
+	void on_flip() {}
+	void on_split() {}
+	void on_merge() {}
+	void on_maintain() {}
+	container_stats snapshot() const { return container_stats(); }
+};
+
+/**
+ * counts every hook, e.g. sjtu::vector<int, sjtu::count_stats>.
+ */
+class count_stats {
+private:
+	container_stats counts;
+public:
+	void on_allocate(size_t bytes) {
+		counts.allocations++;
+		counts.bytes_allocated += bytes;
+	}
+	void on_deallocate(size_t bytes) {
+		counts.deallocations++;
+		counts.bytes_freed += bytes;
+	}
+	void on_reallocate(size_t copied) {
+		counts.reallocations++;
+		counts.copies += copied;
+	}
+	// storage moved to or from another container: nothing is allocated or freed, only the owner changes
+	void on_give(size_t bytes) { counts.bytes_freed += bytes; }
+	void on_take(size_t bytes) { counts.bytes_allocated += bytes; }
+	void on_rotate() { counts.rotations++; }
+	void on_flip() { counts.color_flips++; }
+	void on_split() { counts.splits++; }
+	void on_merge() { counts.merges++; }
+	void on_maintain() { counts.maintains++; }
+	container_stats snapshot() const { return counts; }
+};
+
+}
+
+#endif
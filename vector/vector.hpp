@@ -2,18 +2,21 @@
 #define SJTU_VECTOR_HPP
 
 #include "exceptions.hpp"
+#include "stats.hpp"
 #include <new>
 #include <climits>
 #include <cstddef>
+#include <utility>
 #include <vector>
 
 namespace sjtu {
 /**
  * a data container like std::vector
  * store data in a successive memory and support random access.
+ * Stats is the statistics policy, see stats.hpp; no_stats costs nothing.
  */
-template<typename T>
-class vector {
+template<typename T, class Stats = no_stats>
+class vector : private Stats {
 public:
 	/**
 	 * TODO
@@ -118,13 +121,24 @@ private:
 	int maxSize;
 	int currentLength;
 
+	T *allocate(int n){
+		Stats::on_allocate(sizeof(T)*n);
+		return (T*)malloc(sizeof(T)*n);
+	}
+	void deallocate(){
+		Stats::on_deallocate(sizeof(T)*maxSize);
+		free(data);
+	}
+
 	void doubleSpace(){
-		maxSize*=2;
-		T* tmp=(T*)malloc(sizeof(T)*maxSize);
+		T* tmp=allocate(maxSize*2);
+		Stats::on_reallocate(currentLength);
 		for (int i = 0; i < currentLength; i++) {
-			tmp[i]=data[i];
+			new(&tmp[i])T(std::move(data[i]));
+			data[i].~T();
 		}
-		free(data);
+		deallocate();
+		maxSize*=2;
 		data=tmp;
 	}
 public:
@@ -133,7 +147,7 @@ public:
 	 * Atleast three: default constructor, copy constructor and a constructor for std::vector
 	 */
 	vector(int initSize=16) {
-		data=(T*)malloc(sizeof(T)*initSize);
+		data=allocate(initSize);
 
 		maxSize=initSize;
 		currentLength=0;
@@ -141,18 +155,18 @@ public:
 	vector(const vector &other) {
 		maxSize=other.maxSize;
 		currentLength=other.currentLength;
-        data=(T*)malloc(sizeof(T)*maxSize);
+        data=allocate(maxSize);
 		for (int i = 0; i < currentLength; i++) {
-			data[i]=other.data[i];
+			new(&data[i])T(other.data[i]);
 		}
 	}
 
 	vector (const std::vector<T> &other){
 		maxSize=other.capacity();
 		currentLength=other.size();
-		data=malloc(sizeof(T)*maxSize);
+		data=allocate(maxSize);
 		for (int i = 0; i < currentLength; i++) {
-			data[i]=other[i];
+			new(&data[i])T(other[i]);
 		}
 	}
 	/**
@@ -162,7 +176,7 @@ public:
         for (int i = 0; i < currentLength; i++) {
             data[i].~T();
         }
-		free(data);
+		deallocate();
 	}
 	/**
 	 * TODO Assignment operator
@@ -171,12 +185,12 @@ public:
         for (int i = 0; i < currentLength; i++) {
             data[i].~T();
         }
-		free(data);
+		deallocate();
 		maxSize=other.maxSize;
 		currentLength=other.currentLength;
-        data=(T*)malloc(sizeof(T)*maxSize);
+        data=allocate(maxSize);
 		for (int i = 0; i < currentLength; i++) {
-			data[i]=other.data[i];
+			new(&data[i])T(other.data[i]);
 		}
 		return *this;
 	}
@@ -185,13 +199,13 @@ public:
 	 * throw index_out_of_bound if pos is not in [0, size)
 	 */
 	T & at(const size_t &pos) {
-		if (pos < 0 || pos > size()) {
+		if (pos >= size()) {
 			throw index_out_of_bound();
 		}
 		return data[pos];
 	}
 	const T & at(const size_t &pos) const {
-		if (pos < 0 || pos > size()) {
+		if (pos >= size()) {
 			throw index_out_of_bound();
 		}
 		return data[pos];
@@ -348,6 +362,21 @@ public:
 		}
 		currentLength--;
 	}
+	/**
+	 * what this vector has done so far, all zero unless Stats counts.
+	 */
+	container_stats stats() const {
+		return Stats::snapshot();
+	}
+	/**
+	 * bytes held, the unused capacity counts as overhead.
+	 */
+	container_memory memory_usage() const {
+		container_memory m;
+		m.payload=sizeof(T)*currentLength;
+		m.overhead=sizeof(vector)+sizeof(T)*(maxSize-currentLength);
+		return m;
+	}
 };
 
 